@@ -0,0 +1 @@
+#include <ugcd_compat.h>
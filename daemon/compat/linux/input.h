@@ -0,0 +1,2 @@
+#include_next <linux/input.h>
+#include <ugcd_compat.h>
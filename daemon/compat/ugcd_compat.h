@@ -0,0 +1,123 @@
+#ifndef INCLUDED_UGCD_COMPAT_H_
+#define INCLUDED_UGCD_COMPAT_H_
+
+// Just enough of the kernel's API for the shared core in src/ to build
+// against libc. Each linux/ header here includes this one, and the uapi
+// headers it shadows where there are any.
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include_next <linux/types.h>
+
+typedef __u8 u8;
+typedef __u16 u16;
+typedef __u32 u32;
+typedef __u64 u64;
+typedef __s8 s8;
+typedef __s16 s16;
+typedef __s32 s32;
+typedef __s64 s64;
+
+#define U8_MAX ((u8)~0U)
+#define U16_MAX ((u16)~0U)
+#define U32_MAX ((u32)~0U)
+#define U64_MAX ((u64)~0ULL)
+#define S32_MAX ((s32)(U32_MAX >> 1))
+#define S32_MIN ((s32)(-S32_MAX - 1))
+
+#define BIT(nr) (1UL << (nr))
+#define BIT_ULL(nr) (1ULL << (nr))
+#define GENMASK_ULL(high, low) \
+    ((~0ULL << (low)) & (~0ULL >> (63 - (high))))
+#define BITS_PER_LONG (CHAR_BIT * sizeof(long))
+
+#define likely(x) __builtin_expect(!!(x), 1)
+#define unlikely(x) __builtin_expect(!!(x), 0)
+
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+
+#define min(x, y) ({ \
+    __typeof__(x) _x = (x); __typeof__(y) _y = (y); _x < _y ? _x : _y; })
+#define max(x, y) ({ \
+    __typeof__(x) _x = (x); __typeof__(y) _y = (y); _x > _y ? _x : _y; })
+#define min_t(type, x, y) min((type)(x), (type)(y))
+#define max_t(type, x, y) max((type)(x), (type)(y))
+#define clamp_t(type, value, low, high) \
+    min_t(type, max_t(type, value, low), high)
+
+static inline unsigned int hweight64(u64 word) {
+  return __builtin_popcountll(word);
+}
+static inline int fls64(u64 word) {
+  return word ? 64 - __builtin_clzll(word) : 0;
+}
+// undefined for 0, as in the kernel
+static inline unsigned int __ffs64(u64 word) {
+  return __builtin_ctzll(word);
+}
+static inline bool test_bit(unsigned int nr, const unsigned long *bitmap) {
+  return (bitmap[nr / BITS_PER_LONG] >> (nr % BITS_PER_LONG)) & 1;
+}
+
+static inline u64 div_u64(u64 dividend, u32 divisor) {
+  return dividend / divisor;
+}
+static inline u64 div64_u64(u64 dividend, u64 divisor) {
+  return dividend / divisor;
+}
+static inline s64 div_s64(s64 dividend, s32 divisor) {
+  return dividend / divisor;
+}
+
+// the swap function is never used by the core
+static inline void sort(void *base, size_t num, size_t size,
+    int (*compare)(const void *, const void *), void *swap) {
+  qsort(base, num, size, compare);
+}
+
+static inline int kstrtouint(const char *text, unsigned int base,
+    unsigned int *value) {
+  char *end;
+  unsigned long result;
+  if (*text == '\0' || *text == '-') {
+    return -EINVAL;
+  }
+  errno = 0;
+  result = strtoul(text, &end, base);
+  if (*end == '\n') {
+    ++end;
+  }
+  if (*end != '\0') {
+    return -EINVAL;
+  }
+  if (errno == ERANGE || result > UINT_MAX) {
+    return -ERANGE;
+  }
+  *value = result;
+  return 0;
+}
+
+#define GFP_KERNEL 0
+#define kmalloc(size, gfp) malloc(size)
+#define kzalloc(size, gfp) calloc(1, size)
+#define kfree(pointer) free(pointer)
+
+// only ever embedded in the core's structures, never used
+struct list_head {
+  struct list_head *next, *prev;
+};
+struct mutex {
+  int unused;
+};
+struct dentry;
+struct input_handle;
+struct input_dev;
+
+#endif  // INCLUDED_UGCD_COMPAT_H_
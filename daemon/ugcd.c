@@ -0,0 +1,801 @@
+// ugcd: the console side of universal_game_controller as a userspace
+// daemon, for systems that can't load the module. Pads are read from evdev
+// and mapped by the module's own core (src/), built against compat/, and the
+// console's latch and clock arrive as libgpiod v2 edge events.
+//
+// Two threads share the report the way the module's event handler and
+// latch interrupt do: the main thread reads every pad through epoll and
+// publishes one merged report word, and the bus thread, SCHED_FIFO and
+// pinned, answers the edges. Its edge histogram has the module's buckets
+// but is measured from the timestamp gpiolib takes in its interrupt handler
+// to the data line being driven, a different start from the module's poll
+// engine; see stats.h before comparing.
+
+#include <ugc/binding_table.h>
+#include <ugc/controller_db.h>
+#include <ugc/dpad.h>
+#include <ugc/mapping_text.h>
+#include <ugc/profile.h>
+#include <ugc/snes_report.h>
+#include <ugc/stats.h>
+#include <ugc/tap_capture.h>
+#include <ugc/turbo.h>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <gpiod.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#define UGCD_MAX_DEVICES 8
+// edge events taken from the kernel per read
+#define UGCD_EVENT_BATCH 16
+
+struct Options {
+  const char *chip;
+  unsigned int latch;  // line offsets on chip
+  unsigned int clock;
+  unsigned int data;
+  const char *report_format;
+  const char *mapping;  // text mapping file for every pad, or NULL
+  const char *socd;
+  unsigned int tap_frames[UGC_REPORT_MAX_BITS];
+  unsigned int num_tap_frames;
+  unsigned int turbo_frames[UGC_REPORT_MAX_BITS];
+  unsigned int num_turbo_frames;
+  unsigned int axis_press_percent;
+  unsigned int axis_release_percent;
+  int priority;  // SCHED_FIFO priority of the bus thread; 0 leaves it
+  int cpu;  // CPU the bus thread is pinned to, or -1
+  bool grab;  // EVIOCGRAB each pad
+  bool edge_histogram;
+};
+
+static struct Options g_options = {
+  .chip = "/dev/gpiochip0",
+  // BCM numbering, the module's default pins
+  .latch = 22,
+  .clock = 27,
+  .data = 17,
+  .report_format = "standard",
+  .socd = "none",
+  .axis_press_percent = 50,
+  .axis_release_percent = 35,
+  .priority = 80,
+  .cpu = -1,
+};
+
+struct Stats g_stats;
+
+// A pad, mapped by its profile's first bank. EV_KEY and EV_ABS inputs
+// are bound; EV_REL motion has no held state and is ignored.
+struct Device {
+  int fd;
+  const char *path;
+  struct Profile profile;
+  s8 key_input[KEY_CNT];  // raw bit of each key, or -1
+  s8 abs_input[ABS_CNT][2];  // raw bit of each direction, or -1
+  u64 axes_used;  // bit per ABS_ code with a bound direction
+  struct Axis axes[ABS_CNT];
+  u64 raw;  // held inputs, by raw bit
+  u64 published_raw;
+  u64 report;  // packed report word as of the last Device_Commit
+  bool dropped;  // after SYN_DROPPED, until the next SYN_REPORT
+};
+
+static struct Device *g_devices[UGCD_MAX_DEVICES];
+static unsigned int g_num_devices = 0;
+// compiled from g_options.mapping
+static struct Profile g_mapping;
+
+static const struct SnesReportFormat *g_report_format;
+// merged report of every pad, and the report bits they pressed since the
+// last latch; written by the main thread, taken by the bus thread
+static _Atomic u64 g_report;
+static _Atomic u64 g_taps;
+
+// everything below is the bus thread's alone
+static struct gpiod_line_request *g_request;
+static struct DpadBits g_dpad_bits;
+static struct Socd g_socd;
+static struct TapCapture g_tap_capture;
+static struct Turbo g_turbo;
+static u64 g_latched_line;
+
+// wakes the bus thread to stop
+static int g_stop_fd = -1;
+
+static u64 MonotonicNs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (u64)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+// Bus ------------------------------------------------------------------------
+
+static inline void Bus_SendNextButton(void) {
+  gpiod_line_request_set_value(g_request, g_options.data,
+      (g_latched_line & 1) ? GPIOD_LINE_VALUE_ACTIVE :
+      GPIOD_LINE_VALUE_INACTIVE);
+  g_latched_line >>= 1;
+}
+
+// The module's SnesLatchRise, minus what needs the kernel.
+static void Bus_LatchRise(void) {
+  u64 pressed = atomic_load_explicit(&g_report, memory_order_acquire);
+  const u64 taps = atomic_exchange_explicit(&g_taps, 0,
+      memory_order_acquire);
+  pressed = TapCapture_Latch(&g_tap_capture, pressed, taps);
+  pressed = Turbo_Latch(&g_turbo, pressed);
+  pressed = Socd_Resolve(&g_socd, pressed);
+  g_latched_line = SnesReportFormat_LineWord(g_report_format, pressed);
+  ++g_stats.latches;
+}
+
+static void Bus_Edge(struct gpiod_edge_event *event) {
+  const unsigned int offset = gpiod_edge_event_get_line_offset(event);
+  const bool rising = gpiod_edge_event_get_event_type(event) ==
+      GPIOD_EDGE_EVENT_RISING_EDGE;
+  if (offset == g_options.latch && rising) {
+    Bus_LatchRise();
+  } else {
+    // the latch falling, or the clock rising: the only other edges asked
+    // for
+    Bus_SendNextButton();
+  }
+  if (unlikely(g_options.edge_histogram)) {
+    Stats_RecordEdge(MonotonicNs() -
+        gpiod_edge_event_get_timestamp_ns(event));
+  }
+}
+
+static void *Bus_Run(void *unused) {
+  struct gpiod_edge_event_buffer *buffer =
+      gpiod_edge_event_buffer_new(UGCD_EVENT_BATCH);
+  struct epoll_event event = { .events = EPOLLIN };
+  const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (!buffer || epoll_fd < 0) {
+    perror("bus thread");
+    goto out;
+  }
+  event.data.fd = gpiod_line_request_get_fd(g_request);
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event.data.fd, &event);
+  event.data.fd = g_stop_fd;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event.data.fd, &event);
+  for (;;) {
+    int count, i;
+    if (epoll_wait(epoll_fd, &event, 1, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("epoll_wait");
+      break;
+    }
+    if (event.data.fd == g_stop_fd) {
+      break;
+    }
+    count = gpiod_line_request_read_edge_events(g_request, buffer,
+        UGCD_EVENT_BATCH);
+    if (count < 0) {
+      perror("gpiod_line_request_read_edge_events");
+      break;
+    }
+    for (i = 0; i < count; ++i) {
+      Bus_Edge(gpiod_edge_event_buffer_get_event(buffer, i));
+    }
+  }
+out:
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+  }
+  gpiod_edge_event_buffer_free(buffer);
+  return NULL;
+}
+
+// The latch interrupts on both edges and the clock on its rise, as in the
+// module; data idles low.
+static struct gpiod_line_request *Bus_Request(void) {
+  struct gpiod_chip *chip = gpiod_chip_open(g_options.chip);
+  struct gpiod_line_settings *settings = gpiod_line_settings_new();
+  struct gpiod_line_config *config = gpiod_line_config_new();
+  struct gpiod_request_config *request_config = gpiod_request_config_new();
+  struct gpiod_line_request *request = NULL;
+  if (!chip || !settings || !config || !request_config) {
+    perror(g_options.chip);
+    goto out;
+  }
+  gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+  gpiod_line_settings_set_event_clock(settings, GPIOD_LINE_CLOCK_MONOTONIC);
+  gpiod_line_settings_set_edge_detection(settings, GPIOD_LINE_EDGE_BOTH);
+  if (gpiod_line_config_add_line_settings(config, &g_options.latch, 1,
+      settings) != 0) {
+    goto out;
+  }
+  gpiod_line_settings_set_edge_detection(settings, GPIOD_LINE_EDGE_RISING);
+  if (gpiod_line_config_add_line_settings(config, &g_options.clock, 1,
+      settings) != 0) {
+    goto out;
+  }
+  gpiod_line_settings_reset(settings);
+  gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_OUTPUT);
+  gpiod_line_settings_set_output_value(settings, GPIOD_LINE_VALUE_INACTIVE);
+  if (gpiod_line_config_add_line_settings(config, &g_options.data, 1,
+      settings) != 0) {
+    goto out;
+  }
+  gpiod_request_config_set_consumer(request_config, "ugcd");
+  gpiod_request_config_set_event_buffer_size(request_config,
+      UGCD_EVENT_BATCH * 4);
+  request = gpiod_chip_request_lines(chip, request_config, config);
+out:
+  if (!request) {
+    perror("requesting the console lines");
+  }
+  gpiod_request_config_free(request_config);
+  gpiod_line_config_free(config);
+  gpiod_line_settings_free(settings);
+  if (chip) {
+    gpiod_chip_close(chip);
+  }
+  return request;
+}
+
+// Realtime setup for the bus thread; failures are reported, since a
+// latency-tuned deployment wants to know.
+static int Bus_Start(pthread_t *thread) {
+  pthread_attr_t attr;
+  int result;
+  pthread_attr_init(&attr);
+  if (g_options.priority > 0) {
+    const struct sched_param param = {
+      .sched_priority = g_options.priority,
+    };
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+  }
+  if (g_options.cpu >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(g_options.cpu, &cpus);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+  }
+  result = pthread_create(thread, &attr, Bus_Run, NULL);
+  pthread_attr_destroy(&attr);
+  if (result != 0) {
+    fprintf(stderr, "bus thread (FIFO %d, CPU %d): %s\n", g_options.priority,
+        g_options.cpu, strerror(result));
+    return -result;
+  }
+  pthread_setname_np(*thread, "ugcd_bus");
+  fprintf(stderr, "bus thread: FIFO %d, CPU %d\n", g_options.priority,
+      g_options.cpu);
+  return 0;
+}
+
+// Devices --------------------------------------------------------------------
+
+// Merges every pad's report, as the module's controller does under the or
+// policy. Taps first, so a latch between the two can't report a press
+// twice.
+static void Devices_Publish(u64 taps) {
+  u64 report = 0;
+  unsigned int i;
+  for (i = 0; i < g_num_devices; ++i) {
+    report |= g_devices[i]->report;
+  }
+  if (taps) {
+    atomic_fetch_or_explicit(&g_taps, taps, memory_order_release);
+  }
+  atomic_store_explicit(&g_report, report, memory_order_release);
+}
+
+static void Device_Commit(struct Device *device) {
+  const u64 report = BindingTable_Evaluate(device->profile.banks,
+      device->raw);
+  const u64 taps = report & ~device->report;
+  device->report = report;
+  device->published_raw = device->raw;
+  Devices_Publish(taps);
+}
+
+static inline void Device_SetInput(struct Device *device, int index,
+    bool pressed) {
+  if (index >= 0) {
+    device->raw = (device->raw & ~BIT_ULL(index)) |
+        ((u64)pressed << index);
+  }
+}
+
+static void Device_UpdateAxis(struct Device *device, unsigned int code,
+    s32 value) {
+  struct Axis *axis = device->axes + code;
+  if (Axis_Update(axis, value)) {
+    Device_SetInput(device, device->abs_input[code][0],
+        axis->pressed & UGC_AXIS_NEGATIVE);
+    Device_SetInput(device, device->abs_input[code][1],
+        axis->pressed & UGC_AXIS_POSITIVE);
+  }
+}
+
+// Rebuilds raw from the kernel's key and axis state, like the module's
+// Device_Resync.
+static void Device_Resync(struct Device *device) {
+  unsigned long keys[KEY_CNT / BITS_PER_LONG + 1] = { 0 };
+  unsigned int code;
+  device->raw = 0;
+  ioctl(device->fd, EVIOCGKEY(sizeof(keys)), keys);
+  for (code = 0; code < KEY_CNT; ++code) {
+    Device_SetInput(device, device->key_input[code], test_bit(code, keys));
+  }
+  for (code = 0; code < ABS_CNT; ++code) {
+    struct input_absinfo absinfo;
+    if (!(device->axes_used & BIT_ULL(code)) ||
+        ioctl(device->fd, EVIOCGABS(code), &absinfo) < 0) {
+      continue;
+    }
+    // restarts the hysteresis, so only a press threshold counts
+    device->axes[code].pressed = 0;
+    Device_SetInput(device, device->abs_input[code][0], false);
+    Device_SetInput(device, device->abs_input[code][1], false);
+    Device_UpdateAxis(device, code, absinfo.value);
+  }
+}
+
+static void Device_Event(struct Device *device,
+    const struct input_event *event) {
+  if (event->type == EV_SYN) {
+    if (event->code == SYN_DROPPED) {
+      device->dropped = true;
+    } else if (event->code == SYN_REPORT) {
+      if (unlikely(device->dropped)) {
+        device->dropped = false;
+        Device_Resync(device);
+      }
+      if (device->raw != device->published_raw) {
+        Device_Commit(device);
+      }
+    }
+  } else if (unlikely(device->dropped)) {
+    // read back at the next report
+  } else if (event->type == EV_KEY && event->code < KEY_CNT) {
+    // autorepeat (2) is still held
+    Device_SetInput(device, device->key_input[event->code],
+        event->value != 0);
+  } else if (event->type == EV_ABS && event->code < ABS_CNT &&
+      (device->axes_used & BIT_ULL(event->code))) {
+    Device_UpdateAxis(device, event->code, event->value);
+  }
+}
+
+// As in the module: a pad's motion sensors and touchpad share its id, so
+// an entry only applies to a device with every input it binds.
+static bool Device_HasInputs(struct Device *device,
+    const struct ControllerDbEntry *entry) {
+  unsigned long keys[KEY_CNT / BITS_PER_LONG + 1] = { 0 };
+  unsigned long axes[ABS_CNT / BITS_PER_LONG + 1] = { 0 };
+  unsigned long motion[REL_CNT / BITS_PER_LONG + 1] = { 0 };
+  unsigned int i;
+  ioctl(device->fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys);
+  ioctl(device->fd, EVIOCGBIT(EV_ABS, sizeof(axes)), axes);
+  ioctl(device->fd, EVIOCGBIT(EV_REL, sizeof(motion)), motion);
+  for (i = 0; i < entry->num_inputs; ++i) {
+    const struct ControllerDbInput *input = entry->inputs + i;
+    if (!(input->type == EV_KEY && input->code < KEY_CNT &&
+            test_bit(input->code, keys)) &&
+        !(input->type == EV_ABS && input->code < ABS_CNT &&
+            test_bit(input->code, axes)) &&
+        !(input->type == EV_REL && input->code < REL_CNT &&
+            test_bit(input->code, motion))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The pad's profile: the --mapping text, or its controller database entry.
+static int Device_LoadProfile(struct Device *device) {
+  struct input_id id;
+  const struct ControllerDbEntry *entry;
+  if (g_options.mapping) {
+    device->profile = g_mapping;
+    return 0;
+  }
+  if (ioctl(device->fd, EVIOCGID, &id) < 0) {
+    return -errno;
+  }
+  entry = ControllerDb_Find(id.vendor, id.product, id.version);
+  if (!entry || !Device_HasInputs(device, entry)) {
+    fprintf(stderr, "%s: no mapping for %04x:%04x; pass --mapping\n",
+        device->path, id.vendor, id.product);
+    return -ENOENT;
+  }
+  ControllerDb_ToProfile(entry, g_report_format, &device->profile);
+  fprintf(stderr, "%s: %s\n", device->path, entry->name);
+  return 0;
+}
+
+static struct Device *Device_Open(const char *path) {
+  struct Device *device = calloc(1, sizeof(*device));
+  unsigned long axes[ABS_CNT / BITS_PER_LONG + 1] = { 0 };
+  bool dual_stick;
+  unsigned int i;
+  if (!device) {
+    return NULL;
+  }
+  device->path = path;
+  device->fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (device->fd < 0) {
+    perror(path);
+    goto err_free;
+  }
+  if (Device_LoadProfile(device) != 0) {
+    goto err_close;
+  }
+  memset(device->key_input, -1, sizeof(device->key_input));
+  memset(device->abs_input, -1, sizeof(device->abs_input));
+  ioctl(device->fd, EVIOCGBIT(EV_ABS, sizeof(axes)), axes);
+  dual_stick = test_bit(ABS_X, axes) && test_bit(ABS_Y, axes) &&
+      test_bit(ABS_RX, axes) && test_bit(ABS_RY, axes);
+  for (i = 0; i < device->profile.num_inputs; ++i) {
+    const struct ProfileInput *input = device->profile.input + i;
+    if (input->type == EV_KEY && input->code < KEY_CNT) {
+      device->key_input[input->code] = i;
+    } else if (input->type == EV_ABS && input->code < ABS_CNT) {
+      struct input_absinfo absinfo;
+      if (!(device->axes_used & BIT_ULL(input->code))) {
+        if (ioctl(device->fd, EVIOCGABS(input->code), &absinfo) < 0) {
+          // bound, but not on this pad
+          continue;
+        }
+        Axis_Init(device->axes + input->code, input->code, &absinfo,
+            g_options.axis_press_percent, g_options.axis_release_percent,
+            dual_stick);
+        device->axes_used |= BIT_ULL(input->code);
+      }
+      device->abs_input[input->code][input->positive] = i;
+    }
+  }
+  if (g_options.grab && ioctl(device->fd, EVIOCGRAB, 1) < 0) {
+    perror(path);
+    goto err_close;
+  }
+  Device_Resync(device);
+  return device;
+err_close:
+  close(device->fd);
+err_free:
+  free(device);
+  return NULL;
+}
+
+static void Device_Close(struct Device *device) {
+  close(device->fd);
+  free(device);
+}
+
+// Reads what the pad has queued; returns false once it is gone.
+static bool Device_Read(struct Device *device) {
+  struct input_event events[64];
+  for (;;) {
+    const ssize_t size = read(device->fd, events, sizeof(events));
+    size_t i;
+    if (size < 0) {
+      return errno == EAGAIN || errno == EINTR;
+    }
+    for (i = 0; i < size / sizeof(events[0]); ++i) {
+      Device_Event(device, events + i);
+    }
+  }
+}
+
+static void Devices_Remove(unsigned int index) {
+  fprintf(stderr, "%s: disconnected\n", g_devices[index]->path);
+  Device_Close(g_devices[index]);
+  g_devices[index] = g_devices[--g_num_devices];
+  Devices_Publish(0);
+}
+
+// Setup ----------------------------------------------------------------------
+
+// The module's stats file lines that apply here.
+static void Stats_Print(FILE *file) {
+  unsigned int i;
+  fprintf(file, "latches: %llu\n", (unsigned long long)g_stats.latches);
+  fprintf(file, "taps: %llu sub_frame %llu lost %llu\n",
+      (unsigned long long)g_stats.taps,
+      (unsigned long long)g_stats.taps_sub_frame,
+      (unsigned long long)g_stats.taps_lost);
+  if (g_options.edge_histogram) {
+    fputs("edge_ns:", file);
+    for (i = 0; i < UGC_EDGE_BUCKETS - 1; ++i) {
+      fprintf(file, " <%u %llu", 64u << i,
+          (unsigned long long)g_stats.edge_ns[i]);
+    }
+    fprintf(file, " more %llu\n", (unsigned long long)g_stats.edge_ns[i]);
+  }
+  fflush(file);
+}
+
+// "1,2,3" into values, as module_param_array takes it.
+static int ParseList(const char *text, unsigned int *values,
+    unsigned int *count) {
+  char *end;
+  *count = 0;
+  do {
+    if (*count == UGC_REPORT_MAX_BITS) {
+      return -E2BIG;
+    }
+    values[(*count)++] = strtoul(text, &end, 0);
+    if (end == text || (*end != ',' && *end != '\0')) {
+      return -EINVAL;
+    }
+    text = end + 1;
+  } while (*end == ',');
+  return 0;
+}
+
+static int LoadMapping(const char *path) {
+  static char text[65536];
+  size_t length, error_offset = 0;
+  int result;
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    return -errno;
+  }
+  length = fread(text, 1, sizeof(text), file);
+  fclose(file);
+  result = MappingText_Compile(text, length, g_report_format, &g_mapping,
+      &error_offset);
+  if (result != 0) {
+    fprintf(stderr, "%s: bad binding at offset %zu: %s\n", path,
+        error_offset, strerror(-result));
+  }
+  return result;
+}
+
+static int ParseSocd(const char *name, enum SocdPolicy *policy) {
+  if (strcmp(name, "none") == 0) {
+    *policy = kSocdNone;
+  } else if (strcmp(name, "neutral") == 0) {
+    *policy = kSocdNeutral;
+  } else if (strcmp(name, "up") == 0) {
+    *policy = kSocdUpPriority;
+  } else if (strcmp(name, "last") == 0) {
+    *policy = kSocdLastWins;
+  } else {
+    return -EINVAL;
+  }
+  return 0;
+}
+
+static void Usage(const char *name) {
+  fprintf(stderr,
+      "usage: %s [options] /dev/input/eventN...\n"
+      "  --chip PATH          GPIO chip of the console lines (%s)\n"
+      "  --latch/--clock/--data N\n"
+      "                       line offsets on it (%u/%u/%u)\n"
+      "  --report-format NAME as the module's report_format (%s)\n"
+      "  --mapping FILE       text mapping for every pad, instead of the\n"
+      "                       controller database\n"
+      "  --socd POLICY        none, neutral, up or last (%s)\n"
+      "  --tap-frames LIST    as the module's tap_frames\n"
+      "  --turbo-frames LIST  as the module's turbo_frames\n"
+      "  --axis-press-percent N\n"
+      "                       as the module's axis_press_percent (%u)\n"
+      "  --axis-release-percent N\n"
+      "                       as the module's axis_release_percent (%u)\n"
+      "  --priority N         SCHED_FIFO priority of the bus thread, 0 for\n"
+      "                       none (%d)\n"
+      "  --cpu N              pin the bus thread to a CPU\n"
+      "  --grab               take the pads from other readers\n"
+      "  --edge-histogram     record edge response times\n"
+      "SIGUSR1 prints the stats, as does exiting.\n",
+      name, g_options.chip, g_options.latch, g_options.clock,
+      g_options.data, g_options.report_format, g_options.socd,
+      g_options.axis_press_percent, g_options.axis_release_percent,
+      g_options.priority);
+}
+
+static int ParseOptions(int argc, char **argv) {
+  static const struct option kOptions[] = {
+    { "chip", required_argument, NULL, 'C' },
+    { "latch", required_argument, NULL, 'L' },
+    { "clock", required_argument, NULL, 'K' },
+    { "data", required_argument, NULL, 'D' },
+    { "report-format", required_argument, NULL, 'f' },
+    { "mapping", required_argument, NULL, 'm' },
+    { "socd", required_argument, NULL, 's' },
+    { "tap-frames", required_argument, NULL, 't' },
+    { "turbo-frames", required_argument, NULL, 'T' },
+    { "axis-press-percent", required_argument, NULL, 'a' },
+    { "axis-release-percent", required_argument, NULL, 'r' },
+    { "priority", required_argument, NULL, 'p' },
+    { "cpu", required_argument, NULL, 'c' },
+    { "grab", no_argument, NULL, 'g' },
+    { "edge-histogram", no_argument, NULL, 'e' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 },
+  };
+  int option;
+  while ((option = getopt_long(argc, argv, "h", kOptions, NULL)) != -1) {
+    switch (option) {
+      case 'C': g_options.chip = optarg; break;
+      case 'L': g_options.latch = strtoul(optarg, NULL, 0); break;
+      case 'K': g_options.clock = strtoul(optarg, NULL, 0); break;
+      case 'D': g_options.data = strtoul(optarg, NULL, 0); break;
+      case 'f': g_options.report_format = optarg; break;
+      case 'm': g_options.mapping = optarg; break;
+      case 's': g_options.socd = optarg; break;
+      case 't':
+        if (ParseList(optarg, g_options.tap_frames,
+            &g_options.num_tap_frames) != 0) {
+          fprintf(stderr, "Bad --tap-frames: %s\n", optarg);
+          return -EINVAL;
+        }
+        break;
+      case 'T':
+        if (ParseList(optarg, g_options.turbo_frames,
+            &g_options.num_turbo_frames) != 0) {
+          fprintf(stderr, "Bad --turbo-frames: %s\n", optarg);
+          return -EINVAL;
+        }
+        break;
+      case 'a':
+        g_options.axis_press_percent = strtoul(optarg, NULL, 0);
+        break;
+      case 'r':
+        g_options.axis_release_percent = strtoul(optarg, NULL, 0);
+        break;
+      case 'p': g_options.priority = strtol(optarg, NULL, 0); break;
+      case 'c': g_options.cpu = strtol(optarg, NULL, 0); break;
+      case 'g': g_options.grab = true; break;
+      case 'e': g_options.edge_histogram = true; break;
+      default:
+        Usage(argv[0]);
+        return -EINVAL;
+    }
+  }
+  if (optind == argc || argc - optind > UGCD_MAX_DEVICES) {
+    Usage(argv[0]);
+    return -EINVAL;
+  }
+  return 0;
+}
+
+// Validates the options as the module's Init validates its parameters.
+static int SetupCore(void) {
+  enum SocdPolicy socd_policy;
+  g_report_format = SnesReportFormat_Find(g_options.report_format);
+  if (!g_report_format) {
+    fprintf(stderr, "Unknown report format: %s\n", g_options.report_format);
+    return -EINVAL;
+  }
+  if (g_options.num_tap_frames > 1 &&
+      g_options.num_tap_frames != g_report_format->num_buttons) {
+    fprintf(stderr, "--tap-frames needs 1 or %u values, not %u\n",
+        g_report_format->num_buttons, g_options.num_tap_frames);
+    return -EINVAL;
+  }
+  if (g_options.num_turbo_frames &&
+      g_options.num_turbo_frames != g_report_format->num_buttons) {
+    fprintf(stderr, "--turbo-frames needs %u values, not %u\n",
+        g_report_format->num_buttons, g_options.num_turbo_frames);
+    return -EINVAL;
+  }
+  if (ParseSocd(g_options.socd, &socd_policy) != 0) {
+    fprintf(stderr, "Unknown SOCD policy: %s\n", g_options.socd);
+    return -EINVAL;
+  }
+  if (g_options.axis_press_percent == 0 ||
+      g_options.axis_press_percent > 100 ||
+      g_options.axis_release_percent > g_options.axis_press_percent) {
+    fprintf(stderr, "Axis thresholds out of range: %u/%u\n",
+        g_options.axis_press_percent, g_options.axis_release_percent);
+    return -EINVAL;
+  }
+  DpadBits_Init(&g_dpad_bits, g_report_format);
+  Socd_Init(&g_socd, socd_policy, &g_dpad_bits);
+  TapCapture_Init(&g_tap_capture, g_report_format, g_options.tap_frames,
+      g_options.num_tap_frames);
+  Turbo_Init(&g_turbo, g_report_format, g_options.turbo_frames,
+      g_options.num_turbo_frames);
+  if (g_options.mapping) {
+    return LoadMapping(g_options.mapping);
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  struct epoll_event event = { .events = EPOLLIN };
+  pthread_t bus_thread;
+  sigset_t signals;
+  int epoll_fd, signal_fd;
+  int i, status = EXIT_FAILURE;
+  bool running = true;
+  if (ParseOptions(argc, argv) != 0 || SetupCore() != 0) {
+    return EXIT_FAILURE;
+  }
+  // no page faults once running
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    perror("mlockall");
+    return EXIT_FAILURE;
+  }
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  for (i = optind; i < argc; ++i) {
+    struct Device *device = Device_Open(argv[i]);
+    if (!device) {
+      goto out_devices;
+    }
+    g_devices[g_num_devices++] = device;
+    event.data.ptr = device;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, device->fd, &event);
+  }
+  Devices_Publish(0);
+  // handled through epoll, and blocked before the bus thread inherits them
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  sigaddset(&signals, SIGUSR1);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+  signal_fd = signalfd(-1, &signals, SFD_CLOEXEC);
+  event.data.ptr = NULL;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, signal_fd, &event);
+  g_stop_fd = eventfd(0, EFD_CLOEXEC);
+  g_request = Bus_Request();
+  if (!g_request || Bus_Start(&bus_thread) != 0) {
+    goto out_request;
+  }
+  while (running) {
+    struct epoll_event events[UGCD_MAX_DEVICES + 1];
+    const int count = epoll_wait(epoll_fd, events, ARRAY_SIZE(events), -1);
+    for (i = 0; i < count; ++i) {
+      struct Device *device = events[i].data.ptr;
+      unsigned int index;
+      if (!device) {
+        struct signalfd_siginfo info;
+        if (read(signal_fd, &info, sizeof(info)) == sizeof(info) &&
+            info.ssi_signo == SIGUSR1) {
+          Stats_Print(stdout);
+        } else {
+          running = false;
+        }
+        continue;
+      }
+      if (Device_Read(device)) {
+        continue;
+      }
+      for (index = 0; g_devices[index] != device; ++index) {
+      }
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, device->fd, NULL);
+      Devices_Remove(index);
+    }
+  }
+  eventfd_write(g_stop_fd, 1);
+  pthread_join(bus_thread, NULL);
+  Stats_Print(stdout);
+  status = EXIT_SUCCESS;
+out_request:
+  if (g_request) {
+    gpiod_line_request_release(g_request);
+  }
+  close(g_stop_fd);
+  close(signal_fd);
+out_devices:
+  while (g_num_devices) {
+    Device_Close(g_devices[--g_num_devices]);
+  }
+  close(epoll_fd);
+  return status;
+}
@@ -0,0 +1,89 @@
+#ifndef INCLUDED_UGC_AXIS_H_
+#define INCLUDED_UGC_AXIS_H_
+
+#include <linux/bits.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>  // min_t
+#include <linux/input.h>
+#include <linux/types.h>
+
+// Axis_Quantize maps each side of the center onto this many steps.
+#define UGC_AXIS_QUANTA 16
+
+// Directions of an axis, each bindable as a digital input.
+#define UGC_AXIS_NEGATIVE BIT(0)
+#define UGC_AXIS_POSITIVE BIT(1)
+
+// An EV_ABS axis seen as two buttons. Thresholds are precomputed from the
+// calibrated range, so a sample costs two compares in the common case. The
+// release thresholds sit nearer the center than the press ones, so a stick
+// jittering around a threshold doesn't flap its bit.
+//
+// Hats (-1..1) press at +-1 and release at 0. Triggers rest at their
+// minimum, so they only have a positive direction.
+struct Axis {
+  s32 minimum;  // calibrated range; widens to any value seen outside it
+  s32 maximum;
+  s32 center;
+  s32 press_low;  // at or below: negative pressed
+  s32 release_low;  // above: negative released
+  s32 press_high;  // at or above: positive pressed
+  s32 release_high;  // below: positive released
+  u32 scale_low;  // Q16 steps per unit of travel below the center
+  u32 scale_high;
+  s32 value;  // last sample
+  u16 flat;
+  u8 press_percent;  // of the travel from the center
+  u8 release_percent;
+  u8 pressed;  // UGC_AXIS_* bits
+};
+
+// Percents are of the travel from the center; release <= press. Unsigned
+// ABS_Z/ABS_RZ are triggers only with dual_stick, when the device also has
+// ABS_X/ABS_Y and ABS_RX/ABS_RY; otherwise they are taken for a stick.
+void Axis_Init(struct Axis *axis, unsigned int code,
+    const struct input_absinfo *absinfo, unsigned int press_percent,
+    unsigned int release_percent, bool dual_stick);
+
+// Widens the range to take value and recomputes the thresholds.
+void Axis_Calibrate(struct Axis *axis, s32 value);
+
+// Returns the UGC_AXIS_* bits whose state value changed; axis->pressed has
+// the new state.
+static inline unsigned int Axis_Update(struct Axis *axis, s32 value) {
+  unsigned int pressed = axis->pressed;
+  unsigned int changed;
+  axis->value = value;
+  if (unlikely(value < axis->minimum || value > axis->maximum)) {
+    Axis_Calibrate(axis, value);
+  }
+  if (value <= axis->press_low) {
+    pressed |= UGC_AXIS_NEGATIVE;
+  } else if (value > axis->release_low) {
+    pressed &= ~UGC_AXIS_NEGATIVE;
+  }
+  if (value >= axis->press_high) {
+    pressed |= UGC_AXIS_POSITIVE;
+  } else if (value < axis->release_high) {
+    pressed &= ~UGC_AXIS_POSITIVE;
+  }
+  changed = pressed ^ axis->pressed;
+  axis->pressed = pressed;
+  return changed;
+}
+
+// The last sample as a step in [0, 2 * UGC_AXIS_QUANTA); the center falls
+// between steps UGC_AXIS_QUANTA - 1 and UGC_AXIS_QUANTA. A multiply and a
+// shift, with no division.
+static inline unsigned int Axis_Quantize(const struct Axis *axis) {
+  const s64 offset = (s64)axis->value - axis->center;
+  u64 step;
+  if (offset >= 0) {
+    step = ((u64)offset * axis->scale_high) >> 16;
+    return UGC_AXIS_QUANTA + min_t(u64, step, UGC_AXIS_QUANTA - 1);
+  }
+  step = ((u64)-offset * axis->scale_low) >> 16;
+  return UGC_AXIS_QUANTA - 1 - min_t(u64, step, UGC_AXIS_QUANTA - 1);
+}
+
+#endif  // INCLUDED_UGC_AXIS_H_
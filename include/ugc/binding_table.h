@@ -0,0 +1,56 @@
+#ifndef INCLUDED_UGC_BINDING_TABLE_H_
+#define INCLUDED_UGC_BINDING_TABLE_H_
+
+#include <linux/types.h>
+
+// Distinct inputs of a device; each is a bit of its raw input word.
+#define UGC_MAX_INPUTS 50
+// One rule per distinct input combination, so fan-out is a rule with
+// several output bits rather than several rules.
+#define UGC_MAX_RULES 32u
+// Binding tables a device can switch between.
+#define UGC_MAX_BANKS 4
+
+// Inputs are identified by their bit in a device's raw input word, and
+// outputs by their bit in the packed report word.
+struct BindingRule {
+  u64 inputs;  // fires when all of these are held
+  u64 output;  // report bits it produces
+  u64 consumes;  // inputs that no later rule may use once this one fires
+};
+
+// Compiled bindings of a device. Rules are ordered from the largest chord
+// down to single inputs, so a chord takes precedence over the bindings of
+// its own inputs.
+struct BindingTable {
+  unsigned int num_rules;
+  struct BindingRule rule[UGC_MAX_RULES];
+};
+
+void BindingTable_Init(struct BindingTable *table);
+
+// Binds the combination inputs to the report bits output, merging with an
+// existing rule for the same combination. Returns false when full.
+bool BindingTable_Add(struct BindingTable *table, u64 inputs, u64 output);
+
+// Orders the rules for evaluation; call after the last BindingTable_Add.
+void BindingTable_Compile(struct BindingTable *table);
+
+// Report bits produced by the held inputs raw.
+static inline u64 BindingTable_Evaluate(const struct BindingTable *table,
+    u64 raw) {
+  const struct BindingRule *rule = table->rule;
+  const struct BindingRule * const end = rule + table->num_rules;
+  u64 output = 0;
+  u64 consumed = 0;
+  for (; rule != end; ++rule) {
+    if ((raw & rule->inputs) == rule->inputs &&
+        !(consumed & rule->inputs)) {
+      output |= rule->output;
+      consumed |= rule->consumes;
+    }
+  }
+  return output;
+}
+
+#endif  // INCLUDED_UGC_BINDING_TABLE_H_
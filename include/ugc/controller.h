@@ -0,0 +1,90 @@
+#ifndef INCLUDED_UGC_CONTROLLER_H_
+#define INCLUDED_UGC_CONTROLLER_H_
+
+#include <linux/atomic.h>
+#include <linux/rcupdate.h>
+#include <linux/spinlock.h>
+#include <linux/types.h>
+
+#define UGC_MAX_MEMBERS 8u
+
+enum MergePolicy {
+  kMergeReplace = 0,  // the newest member replaces all others
+  kMergeOr,  // every member contributes all of its bound buttons
+  kMergePriority,  // a button belongs to the earliest member binding it
+};
+
+struct ControllerMember {
+  const atomic64_t *report;  // owned by the member's device
+  atomic64_t *taps;  // buttons pressed since the last latch; also owned
+  u64 bound;  // buttons the device has bindings for
+  u64 mask;  // buttons it contributes under the merge policy
+};
+
+// Immutable once published; replaced wholesale on membership changes.
+struct ControllerMembers {
+  struct rcu_head rcu;
+  unsigned int count;
+  struct ControllerMember member[UGC_MAX_MEMBERS];
+};
+
+// A virtual controller merged from the packed reports of several devices.
+// Devices publish their own report words without any shared lock; the
+// membership lock is only taken when a device joins or leaves.
+struct Controller {
+  enum MergePolicy policy;
+  spinlock_t lock;  // serializes membership changes
+  struct ControllerMembers __rcu *members;
+};
+
+int Controller_Init(struct Controller *controller, enum MergePolicy policy);
+void Controller_Release(struct Controller *controller);
+
+// Safe from atomic context. Returns -ENOSPC when full.
+int Controller_Add(struct Controller *controller, const atomic64_t *report,
+    atomic64_t *taps, u64 bound);
+// Republishes the member with report under its new bound, e.g. after it
+// gained a bank. Safe from atomic context. Returns -ENOENT for a device that
+// isn't a member.
+int Controller_Update(struct Controller *controller, const atomic64_t *report,
+    u64 bound);
+// May sleep. The latch may still read report until an RCU grace period
+// has passed.
+void Controller_Remove(struct Controller *controller,
+    const atomic64_t *report);
+
+// Called from the latch interrupt.
+static inline u64 Controller_Latch(struct Controller *controller) {
+  const struct ControllerMembers *members;
+  u64 pressed = 0;
+  unsigned int i;
+  rcu_read_lock();
+  members = rcu_dereference(controller->members);
+  for (i = 0; i < members->count; ++i) {
+    pressed |= atomic64_read(members->member[i].report) &
+        members->member[i].mask;
+  }
+  rcu_read_unlock();
+  return pressed;
+}
+
+// Called from the latch interrupt; also consumes each member's taps with
+// one exchange, returning them in *taps.
+static inline u64 Controller_LatchTaps(struct Controller *controller,
+    u64 *taps) {
+  const struct ControllerMembers *members;
+  u64 pressed = 0;
+  unsigned int i;
+  *taps = 0;
+  rcu_read_lock();
+  members = rcu_dereference(controller->members);
+  for (i = 0; i < members->count; ++i) {
+    const struct ControllerMember *member = members->member + i;
+    pressed |= atomic64_read(member->report) & member->mask;
+    *taps |= atomic64_xchg(member->taps, 0) & member->mask;
+  }
+  rcu_read_unlock();
+  return pressed;
+}
+
+#endif  // INCLUDED_UGC_CONTROLLER_H_
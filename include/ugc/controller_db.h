@@ -0,0 +1,43 @@
+#ifndef INCLUDED_UGC_CONTROLLER_DB_H_
+#define INCLUDED_UGC_CONTROLLER_DB_H_
+
+#include <linux/types.h>
+
+#include <ugc/profile.h>
+#include <ugc/snes_report.h>
+
+// Default mappings for common pads, compiled in from data/controller_db.txt
+// so they are ready the moment they connect.
+struct ControllerDbInput {
+  u16 type;
+  u16 code;
+  bool positive;
+};
+
+struct ControllerDbRule {
+  u64 inputs;  // indexes into the entry's inputs
+  u16 output;  // SNES joypad buttons, in standard report order
+};
+
+struct ControllerDbEntry {
+  u16 vendor;
+  u16 product;
+  u16 version;
+  bool any_version;
+  const char *name;
+  u8 num_inputs;
+  const struct ControllerDbInput *inputs;
+  u8 num_rules;
+  const struct ControllerDbRule *rules;
+};
+
+// Binary search on input_dev->id; an exact version wins over any version.
+const struct ControllerDbEntry *ControllerDb_Find(u16 vendor, u16 product,
+    u16 version);
+
+// Fills profile's inputs and first bank from entry, with outputs mapped to
+// format by button. The profile's id is left alone.
+void ControllerDb_ToProfile(const struct ControllerDbEntry *entry,
+    const struct SnesReportFormat *format, struct Profile *profile);
+
+#endif  // INCLUDED_UGC_CONTROLLER_DB_H_
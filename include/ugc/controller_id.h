@@ -22,5 +22,9 @@ void ControllerId_Set(struct ControllerId* id, const char* name,
     const char* uniq, const char* phys, __u16 bustype);
 void ControllerId_Populate(struct ControllerId* id,
     struct input_handle *handle);
+void ControllerId_PopulateFromDev(struct ControllerId* id,
+    struct input_dev *dev);
+bool ControllerId_Equal(const struct ControllerId* lhs,
+    const struct ControllerId* rhs);
 
 #endif  // INCLUDED_UGC_CONTROLLER_ID_H_
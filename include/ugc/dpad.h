@@ -0,0 +1,104 @@
+#ifndef INCLUDED_UGC_DPAD_H_
+#define INCLUDED_UGC_DPAD_H_
+
+#include <linux/types.h>
+
+#include <ugc/axis.h>
+#include <ugc/snes_report.h>
+
+// D-pad directions, as a 4-bit index.
+#define UGC_DPAD_UP BIT(0)
+#define UGC_DPAD_DOWN BIT(1)
+#define UGC_DPAD_LEFT BIT(2)
+#define UGC_DPAD_RIGHT BIT(3)
+#define UGC_DPAD_COMBINATIONS 16
+
+#define UGC_STICK_STEPS (2 * UGC_AXIS_QUANTA)
+
+// Report bits of the format's d-pad, by UGC_DPAD_* combination.
+struct DpadBits {
+  u64 bits[UGC_DPAD_COMBINATIONS];
+};
+
+void DpadBits_Init(struct DpadBits *dpad, const struct SnesReportFormat *format);
+
+static inline u64 DpadBits_All(const struct DpadBits *dpad) {
+  return dpad->bits[UGC_DPAD_COMBINATIONS - 1];
+}
+
+// Quantizes a stick into 4 or 8 directions. The sector of every quantized
+// X/Y cell is worked out once, so a sample is two Axis_Quantize calls and
+// a table load rather than any trigonometry.
+struct StickDpad {
+  u8 sector[UGC_STICK_STEPS][UGC_STICK_STEPS];  // [y][x]: UGC_DPAD_* bits
+};
+
+// diagonal_degrees is the width of each diagonal sector with 8 ways; the
+// cardinal ones share the rest. deadzone_percent of the radius maps to no
+// direction.
+int StickDpad_Init(struct StickDpad *stick, unsigned int ways,
+    unsigned int diagonal_degrees, unsigned int deadzone_percent);
+
+static inline unsigned int StickDpad_Direction(const struct StickDpad *stick,
+    const struct Axis *x, const struct Axis *y) {
+  return stick->sector[Axis_Quantize(y)][Axis_Quantize(x)];
+}
+
+// Simultaneous opposite cardinal directions, resolved on the packed report
+// word once per frame.
+enum SocdPolicy {
+  kSocdNone = 0,  // pass both through
+  kSocdNeutral,  // opposites cancel out
+  kSocdUpPriority,  // Up wins over Down; Left and Right cancel out
+  kSocdLastWins,  // the direction pressed most recently wins
+};
+
+struct Socd {
+  enum SocdPolicy policy;
+  u64 up, down, left, right;
+  u64 previous;  // last unresolved report, for kSocdLastWins
+  u64 vertical;  // kSocdLastWins: the winning bit while both are held
+  u64 horizontal;
+};
+
+void Socd_Init(struct Socd *socd, enum SocdPolicy policy,
+    const struct DpadBits *dpad);
+
+static inline u64 Socd_ResolvePair(struct Socd *socd, u64 report,
+    u64 first, u64 second, u64 priority, u64 *winner) {
+  const u64 both = first | second;
+  if ((report & both) != both) {
+    *winner = 0;
+    return report;
+  }
+  switch (socd->policy) {
+    case kSocdUpPriority:
+      return report & ~(both & ~priority);
+    case kSocdLastWins:
+      if (!*winner) {
+        // whichever wasn't held last frame; both new cancel out
+        *winner = both & ~socd->previous;
+        if (*winner == both) {
+          *winner = 0;
+        }
+      }
+      return report & ~(both & ~*winner);
+    default:
+      return report & ~both;
+  }
+}
+
+static inline u64 Socd_Resolve(struct Socd *socd, u64 report) {
+  u64 resolved;
+  if (socd->policy == kSocdNone) {
+    return report;
+  }
+  resolved = Socd_ResolvePair(socd, report, socd->up, socd->down, socd->up,
+      &socd->vertical);
+  resolved = Socd_ResolvePair(socd, resolved, socd->left, socd->right, 0,
+      &socd->horizontal);
+  socd->previous = report;
+  return resolved;
+}
+
+#endif  // INCLUDED_UGC_DPAD_H_
@@ -0,0 +1,34 @@
+#ifndef INCLUDED_UGC_GAMEPAD_OUTPUT_H_
+#define INCLUDED_UGC_GAMEPAD_OUTPUT_H_
+
+#include <linux/input.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
+
+#include <ugc/snes_report.h>
+
+// Exposes the mapped controller as an input device of its own, for hosts
+// that run emulators instead of being wired to a console.
+struct GamepadOutput {
+  const struct SnesReportFormat *format;
+  struct input_dev *input;
+  spinlock_t lock;  // devices commit frames from any CPU
+  u64 report;  // as last committed
+  u64 taps;  // bits committed pressed since the last emit
+  u64 shadow;  // report as last emitted
+  // emits outside the committing device's event_lock, which is of the same
+  // class as the gamepad's own
+  struct work_struct emit;
+};
+
+int GamepadOutput_Setup(struct GamepadOutput *output,
+    const struct SnesReportFormat *format);
+void GamepadOutput_Release(struct GamepadOutput *output);
+
+// Queues the buttons that differ from the shadow report to be emitted,
+// followed by a single SYN_REPORT. Does nothing when nothing changed.
+// A press released again before the emit is sent as a frame of its own.
+// Safe from any context.
+void GamepadOutput_Commit(struct GamepadOutput *output, u64 report);
+
+#endif  // INCLUDED_UGC_GAMEPAD_OUTPUT_H_
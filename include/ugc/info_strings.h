@@ -11,4 +11,11 @@ void GetKeyName(unsigned int code, const char** code_name);
 void GetEventName(unsigned int type, unsigned int code,
       const char** event_name, const char** code_name);
 
+// Resolves the first `length` characters of `name`, e.g. "BTN_SOUTH", to an
+// event type and code. Returns -ENOENT for unknown names, and for every name
+// when the module is built without UGC_NAME_TABLES; the getters above return
+// NULL names in that build.
+int GetEventCode(const char* name, size_t length,
+      unsigned int* type, unsigned int* code);
+
 #endif  // INCLUDED_UGC_INFO_STRINGS_H_
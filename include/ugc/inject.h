@@ -0,0 +1,66 @@
+#ifndef INCLUDED_UGC_INJECT_H_
+#define INCLUDED_UGC_INJECT_H_
+
+#include <linux/types.h>
+
+// Layout of the page mapped from /dev/ugc_inject, shared with userspace:
+//
+//   fd = open("/dev/ugc_inject", O_RDWR);
+//   page = mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+//   page->report = held;  // plain stores; the latch reads the latest
+//   __atomic_fetch_or(&page->taps, tapped, __ATOMIC_RELEASE);
+//
+// Words are packed like the report word (see snes_report.h). Every
+// format fits in the low 32 bits, so a 64-bit word torn on a 32-bit CPU
+// can't split a report. taps is 32 bits so that the kernel's exchange is
+// atomic against the writer's on every CPU; ARMv6 emulates 64-bit atomics
+// with a lock userspace doesn't take. The page is cleared when the last
+// file closes, so a writer that dies doesn't leave buttons held.
+struct UgcInjectPage {
+  __u64 report;  // buttons held
+  __u64 mask;  // with the override policy, the bits report decides
+  __u32 taps;  // buttons to report for at least the next latch
+  __u32 reserved;
+};
+
+#ifdef __KERNEL__
+
+#include <linux/atomic.h>
+#include <linux/compiler.h>
+#include <linux/miscdevice.h>
+
+enum InjectPolicy {
+  kInjectOff = 0,
+  kInjectOr,  // injected buttons are pressed as well
+  kInjectOverride,  // injected state replaces devices' for mask bits
+};
+
+struct Inject {
+  struct miscdevice misc;
+  struct UgcInjectPage *page;  // NULL while off
+  enum InjectPolicy policy;
+  atomic_t openers;
+};
+
+int Inject_Setup(struct Inject *inject, enum InjectPolicy policy);
+void Inject_Release(struct Inject *inject);
+
+// Called from the latch interrupt with the devices' buttons and taps;
+// merges in the injected ones. Call only while the policy isn't off.
+static inline u64 Inject_Latch(struct Inject *inject, u64 pressed,
+    u64 *taps) {
+  struct UgcInjectPage *page = inject->page;
+  const u64 report = READ_ONCE(page->report);
+  if (READ_ONCE(page->taps)) {
+    *taps |= xchg(&page->taps, 0);
+  }
+  if (inject->policy == kInjectOverride) {
+    const u64 mask = READ_ONCE(page->mask);
+    return (pressed & ~mask) | (report & mask);
+  }
+  return pressed | report;
+}
+
+#endif  // __KERNEL__
+
+#endif  // INCLUDED_UGC_INJECT_H_
@@ -0,0 +1,26 @@
+#ifndef INCLUDED_UGC_INTERPOSER_H_
+#define INCLUDED_UGC_INTERPOSER_H_
+
+#include <linux/ktime.h>
+
+#include <ugc/pad_reader.h>
+
+// Sits between a real pad and the console. The pad is read ahead of each
+// predicted console latch so its report is already complete when the
+// latch arrives, and the latch only has to OR it in.
+struct Interposer {
+  struct PadReader *reader;
+  ktime_t lead;  // margin between a read completing and the latch
+
+  ktime_t last_latch;
+  s64 period_ns;  // predicted latch period; 0 until one has been seen
+};
+
+void Interposer_Init(struct Interposer *interposer,
+    struct PadReader *reader, ktime_t lead);
+
+// Called on each console latch rise. Returns the pad report to merge and
+// schedules the read for the next frame.
+u64 Interposer_Latch(struct Interposer *interposer, ktime_t now);
+
+#endif  // INCLUDED_UGC_INTERPOSER_H_
@@ -0,0 +1,55 @@
+#ifndef INCLUDED_UGC_MAPPING_BPF_H_
+#define INCLUDED_UGC_MAPPING_BPF_H_
+
+#include <linux/kconfig.h>
+#include <linux/rbtree.h>
+#include <linux/types.h>
+
+// An optional BPF stage after the bindings, in the style of HID-BPF. Each
+// committed frame calls ugc_bpf_frame(ctx), an empty function that fmod_ret
+// programs attach to. A program reads ctx and may call the kfunc
+//
+//   void ugc_bpf_set_report(struct ugc_bpf_ctx *ctx, u64 report);
+//
+// to publish its own report word instead, and
+//
+//   int ugc_bpf_input_bit(struct ugc_bpf_ctx *ctx, u32 type, u32 code,
+//       bool positive);
+//
+// to find the raw bit of an evdev input, or -ENOENT if it isn't bound.
+// The controller keeps only the report bits the device's profile binds,
+// so a program can move presses between bound buttons but can't press a
+// button the profile leaves unbound; bind it to some input first.
+// See samples/bpf/swap_layer.bpf.c.
+#if defined(UGC_BPF) && IS_ENABLED(CONFIG_BPF_SYSCALL) && \
+    IS_ENABLED(CONFIG_DEBUG_INFO_BTF_MODULES) && \
+    IS_ENABLED(CONFIG_FUNCTION_ERROR_INJECTION)
+#define UGC_HAS_MAPPING_BPF 1
+#endif
+
+// Names follow the kernel's BPF conventions, since programs see them.
+struct ugc_bpf_ctx {
+  __u64 raw;  // held inputs, by raw bit
+  __u64 report;  // from the bindings and the stick; replaceable
+  __u32 device;  // index in logs
+  __u32 bank;  // active binding bank
+  __u8 stick;  // UGC_DPAD_* bits of the stick
+  bool replaced;  // ugc_bpf_set_report was called
+  struct rb_root *inputs;  // for ugc_bpf_input_bit only
+};
+
+#ifdef UGC_HAS_MAPPING_BPF
+// Registers the kfuncs.
+int MappingBpf_Setup(void);
+// Returns the report to publish for the frame in ctx.
+u64 MappingBpf_Frame(struct ugc_bpf_ctx *ctx);
+#else
+static inline int MappingBpf_Setup(void) {
+  return 0;
+}
+static inline u64 MappingBpf_Frame(struct ugc_bpf_ctx *ctx) {
+  return ctx->report;
+}
+#endif
+
+#endif  // INCLUDED_UGC_MAPPING_BPF_H_
@@ -0,0 +1,28 @@
+#ifndef INCLUDED_UGC_MAPPING_TEXT_H_
+#define INCLUDED_UGC_MAPPING_TEXT_H_
+
+#include <linux/types.h>
+
+#include <ugc/profile.h>
+#include <ugc/snes_report.h>
+
+// Text mappings, in the binding syntax of data/controller_db.txt:
+//
+//   B=BTN_SOUTH A=BTN_EAST Up=ABS_HAT0Y- Start=BTN_START+BTN_SELECT
+//   ---
+//   B=KEY_Z ...
+//
+// Bindings are separated by whitespace and banks by "---"; # comments run to
+// the end of the line. Buttons are named by the report format. Inputs are
+// evdev code names, or type:code numbers, and ABS_ and REL_ inputs take a +
+// or - direction. Inputs joined with + bind a chord, and an input bound to
+// several buttons fans out.
+
+// Compiles text into profile's inputs and banks in one pass; the profile's
+// id is left alone. Returns 0, or a negative error with the offset of the
+// binding at fault in *error_offset.
+int MappingText_Compile(const char* text, size_t length,
+    const struct SnesReportFormat* format, struct Profile* profile,
+    size_t* error_offset);
+
+#endif  // INCLUDED_UGC_MAPPING_TEXT_H_
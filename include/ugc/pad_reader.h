@@ -0,0 +1,41 @@
+#ifndef INCLUDED_UGC_PAD_READER_H_
+#define INCLUDED_UGC_PAD_READER_H_
+
+#include <linux/hrtimer.h>
+#include <linux/input.h>
+#include <linux/atomic.h>
+
+#include <ugc/pin_config.h>
+#include <ugc/snes_report.h>
+
+// Reads a real SNES/NES pad by driving its latch and clock lines. Every
+// half clock is its own hrtimer expiry, so nothing spins between bits.
+struct PadReader {
+  const struct SnesReportFormat *format;
+  struct PinConfig latch;  // output, idles low
+  struct PinConfig clock;  // output, idles high
+  struct PinConfig data;  // input, low == pressed
+  ktime_t period;  // time between the starts of two polls; 0 for on demand
+
+  // NULL when the report is only consumed in-module
+  struct input_dev *input;
+  struct hrtimer timer;
+  ktime_t frame_start;
+  unsigned int step;
+  u64 shift;  // report being read
+  atomic64_t report;  // last complete report
+  atomic64_t completed_ns;  // ktime_get() when it completed
+};
+
+// input_name of NULL skips publishing an input device
+int PadReader_Setup(struct PadReader *reader, const char *input_name);
+void PadReader_Release(struct PadReader *reader);
+
+// Starts one read at the absolute time start, unless one is in progress.
+// Only meaningful for readers with no period.
+void PadReader_Schedule(struct PadReader *reader, ktime_t start);
+
+// How long a read takes from latch rise to the last bit.
+ktime_t PadReader_ReadDuration(const struct PadReader *reader);
+
+#endif  // INCLUDED_UGC_PAD_READER_H_
@@ -1,6 +1,7 @@
 #ifndef INCLUDED_UGC_PIN_CONFIG_H_
 #define INCLUDED_UGC_PIN_CONFIG_H_
 
+#include <linux/cpumask.h>
 #include <linux/interrupt.h>
 #include <linux/gpio.h>
 enum PinState {
@@ -11,6 +12,19 @@ enum PinDirection {
   kInput,
   kOutput,
 };
+// How an input's interrupt is serviced; all zero leaves the kernel's
+// defaults.
+struct PinIrqPolicy {
+  bool no_thread;  // IRQF_NO_THREAD: hard IRQ context even when forced
+  bool no_balancing;  // IRQF_NOBALANCING: irqbalance leaves it alone
+  int priority;  // SCHED_FIFO priority of its thread, 0 for the default
+  struct cpumask cpus;  // affinity, empty for the default
+};
+
+// Fills policy from e.g. "nothread,nobalancing,priority=90,cpus=2-3". cpus
+// comes last, since a CPU list has commas of its own.
+int PinIrqPolicy_Parse(struct PinIrqPolicy *policy, const char *text);
+
 struct PinConfig {
   const char* label;
   int pin_number;
@@ -23,9 +37,12 @@ struct PinConfig {
   unsigned long input_irq_flags;
   int input_irq_number;
   irq_handler_t input_irq_handler;
+  struct PinIrqPolicy input_irq_policy;
 };
 
 bool PinConfig_HasInterrupt(struct PinConfig *config);
+// Applies input_irq_policy, then logs how the interrupt ended up being
+// serviced, failing if that isn't what the policy asked for.
 int PinConfig_Setup(struct PinConfig *config);
 void PinConfig_Release(struct PinConfig *config);
 
@@ -0,0 +1,66 @@
+#ifndef INCLUDED_UGC_PROFILE_H_
+#define INCLUDED_UGC_PROFILE_H_
+
+#include <linux/dcache.h>
+#include <linux/list.h>
+#include <linux/mutex.h>
+#include <linux/types.h>
+
+#include <ugc/binding_table.h>
+#include <ugc/controller_id.h>
+
+// A device's complete configuration, kept across disconnects so a known
+// device is ready as soon as it connects.
+struct ProfileInput {
+  unsigned int type;
+  unsigned int code;
+  bool positive;
+};
+
+struct Profile {
+  struct list_head node;
+  struct ControllerId id;
+  unsigned int num_inputs;
+  struct ProfileInput input[UGC_MAX_INPUTS];  // at the index of the raw bit
+  unsigned int num_banks;
+  struct BindingTable banks[UGC_MAX_BANKS];
+};
+
+struct Profile* Profile_New(void);
+void Profile_Delete(struct Profile* profile);
+
+struct ProfileCache {
+  struct mutex lock;
+  struct list_head profiles;
+};
+
+void ProfileCache_Init(struct ProfileCache* cache);
+void ProfileCache_Clear(struct ProfileCache* cache);
+
+// Takes ownership of profile, replacing any profile with the same id.
+void ProfileCache_Store(struct ProfileCache* cache, struct Profile* profile);
+
+// Call with cache->lock held; the result is only valid while it is.
+const struct Profile* ProfileCache_Find(struct ProfileCache* cache,
+    const struct ControllerId* id);
+
+// Blobs are little endian:
+//   "UGCP", u16 version (1), u16 profile count, then for each profile:
+//   u16 bustype, u16 name/uniq/phys lengths, the strings without NULs,
+//   u8 input count, u8 bank count,
+//   per input: u16 type, u16 code, u8 positive, u8 reserved,
+//   per bank: u8 rule count, then per rule: u64 inputs, u64 output.
+// Loaded profiles are stored in the cache. Returns the count loaded or a
+// negative error, in which case nothing was stored.
+int ProfileCache_LoadBlob(struct ProfileCache* cache, const u8* data,
+    size_t size);
+// Serializes every cached profile; the result is kvfree()d by the caller.
+int ProfileCache_SaveBlob(struct ProfileCache* cache, u8** data,
+    size_t* size);
+
+// Exposes the cache as <parent>/profiles.bin, in the blob format, so the
+// current profiles can be installed as the profile firmware.
+void ProfileCache_CreateDebugfs(struct ProfileCache* cache,
+    struct dentry* parent);
+
+#endif  // INCLUDED_UGC_PROFILE_H_
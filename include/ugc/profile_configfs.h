@@ -0,0 +1,42 @@
+#ifndef INCLUDED_UGC_PROFILE_CONFIGFS_H_
+#define INCLUDED_UGC_PROFILE_CONFIGFS_H_
+
+#include <linux/configfs.h>
+#include <linux/kconfig.h>
+
+#include <ugc/controller_id.h>
+#include <ugc/profile.h>
+#include <ugc/snes_report.h>
+
+// Text mappings uploaded through configfs:
+//
+//   cd /sys/kernel/config/universal_game_controller
+//   mkdir xbox && cd xbox
+//   echo "Microsoft X-Box 360 pad" > name   # also uniq, phys and bustype
+//   echo "B=BTN_A A=BTN_B Up=ABS_HAT0Y- Down=ABS_HAT0Y+" > mapping
+//
+// Writing mapping compiles it (see mapping_text.h) into a profile for the
+// directory's ControllerId, stores it in the cache and calls applied, so a
+// connected device with that id switches to it at once. Removing the
+// directory leaves the cached profile alone.
+struct ProfileConfigfs {
+  struct configfs_subsystem subsystem;
+  struct ProfileCache *cache;
+  const struct SnesReportFormat *format;
+  void (*applied)(const struct ControllerId *id);
+  bool registered;
+};
+
+#if IS_ENABLED(CONFIG_CONFIGFS_FS)
+int ProfileConfigfs_Setup(struct ProfileConfigfs *configfs);
+void ProfileConfigfs_Release(struct ProfileConfigfs *configfs);
+#else
+static inline int ProfileConfigfs_Setup(struct ProfileConfigfs *configfs) {
+  return -ENODEV;
+}
+static inline void ProfileConfigfs_Release(
+    struct ProfileConfigfs *configfs) {
+}
+#endif
+
+#endif  // INCLUDED_UGC_PROFILE_CONFIGFS_H_
@@ -0,0 +1,43 @@
+#ifndef INCLUDED_UGC_SNES_REPORT_H_
+#define INCLUDED_UGC_SNES_REPORT_H_
+
+#include <linux/types.h>
+#include <linux/bits.h>
+
+// Longest report a packed report word can hold.
+#define UGC_REPORT_MAX_BITS 64u
+
+// Describes the serial report a peripheral shifts out after each latch.
+// Bit N of a packed report word is the state sent on clock cycle N+1, with
+// 1 meaning pressed; the line itself is active low.
+struct SnesReportFormat {
+  const char* name;
+  unsigned int length;  // cycles sent before the data line is driven low
+  unsigned int num_buttons;  // number of bindable buttons
+  const unsigned char* button_bit;  // report bit of each bindable button
+  const unsigned int* button_code;  // evdev key code of each button
+  const char* const* button_name;  // name of each button in text mappings
+  u64 id_bits;  // bits always reported as pressed; the peripheral's id
+  u64 line_mask;  // bits [0, length)
+};
+
+const struct SnesReportFormat* SnesReportFormat_Find(const char* name);
+
+// Index of the button called the first length characters of name, or -1.
+int SnesReportFormat_FindButton(const struct SnesReportFormat* format,
+    const char* name, size_t length);
+
+static inline u64 SnesReportFormat_ButtonMask(
+    const struct SnesReportFormat* format, unsigned int button) {
+  return BIT_ULL(format->button_bit[button]);
+}
+
+// Converts a packed report into the levels to put on the data line, one per
+// clock, LSB first. Pressed is low, and since the shift fills with zeros the
+// line also reads low once the report has been sent.
+static inline u64 SnesReportFormat_LineWord(
+    const struct SnesReportFormat* format, u64 pressed) {
+  return ~(pressed | format->id_bits) & format->line_mask;
+}
+
+#endif  // INCLUDED_UGC_SNES_REPORT_H_
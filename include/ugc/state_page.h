@@ -0,0 +1,73 @@
+#ifndef INCLUDED_UGC_STATE_PAGE_H_
+#define INCLUDED_UGC_STATE_PAGE_H_
+
+#include <linux/types.h>
+
+// Layout of the page mapped from /dev/ugc_state, shared with userspace:
+//
+//   fd = open("/dev/ugc_state", O_RDONLY);
+//   page = mmap(NULL, 4096, PROT_READ, MAP_SHARED, fd, 0);
+//
+// Readers retry while sequence is odd or changes across the read:
+//
+//   do {
+//     while ((seq = READ_ONCE(page->sequence)) & 1) {}
+//     smp_rmb();
+//     copy = *page;
+//     smp_rmb();
+//   } while (READ_ONCE(page->sequence) != seq);
+//
+// poll() on the fd reports POLLIN once per frame not yet polled, so a
+// monitor sleeping in poll wakes at most once per latch.
+struct UgcStatePage {
+  __u32 sequence;  // odd while the writer is inside
+  __s32 active_device;  // index in logs, or -1 without one
+  __u64 frame;  // latches (commits in gamepad mode) published
+  __u64 time_ns;  // CLOCK_MONOTONIC of the last one
+  __u64 report;  // packed report word sent for it
+  // fixed at load: button i is pressed when report has bit button_bit[i]
+  __u32 num_buttons;
+  __u8 button_bit[64];
+};
+
+#ifdef __KERNEL__
+
+#include <linux/irq_work.h>
+#include <linux/miscdevice.h>
+#include <linux/wait.h>
+
+#include <ugc/snes_report.h>
+
+struct StatePage {
+  struct miscdevice misc;
+  struct UgcStatePage *page;
+  wait_queue_head_t wait;
+  struct irq_work wake;  // leaves waking pollers out of the latch itself
+};
+
+int StatePage_Setup(struct StatePage *state,
+    const struct SnesReportFormat *format);
+void StatePage_Release(struct StatePage *state);
+
+// Call from one writer at a time: the latch interrupt, or commits under a
+// lock in gamepad mode.
+static inline void StatePage_Publish(struct StatePage *state, u64 report,
+    int active_device, u64 time_ns) {
+  struct UgcStatePage *page = state->page;
+  const u32 sequence = page->sequence;
+  WRITE_ONCE(page->sequence, sequence + 1);
+  smp_wmb();
+  page->active_device = active_device;
+  page->frame = page->frame + 1;
+  page->time_ns = time_ns;
+  page->report = report;
+  smp_wmb();
+  WRITE_ONCE(page->sequence, sequence + 2);
+  if (wq_has_sleeper(&state->wait)) {
+    irq_work_queue(&state->wake);
+  }
+}
+
+#endif  // __KERNEL__
+
+#endif  // INCLUDED_UGC_STATE_PAGE_H_
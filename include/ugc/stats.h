@@ -0,0 +1,62 @@
+#ifndef INCLUDED_UGC_STATS_H_
+#define INCLUDED_UGC_STATS_H_
+
+#include <linux/bitops.h>
+#include <linux/dcache.h>
+#include <linux/kernel.h>
+#include <linux/types.h>
+
+// Edge response buckets: bucket 0 is under 64 ns, and bucket k under
+// 64 << k ns; the last one takes everything slower.
+#define UGC_EDGE_BUCKETS 16
+
+// Counters shown in <debugfs>/universal_game_controller/stats. Each field
+// has a single writer, so they're plain integers; on 32-bit a reader may
+// see a torn 64-bit value, which is acceptable for monitoring.
+struct Stats {
+  u64 latches;
+
+  // buttons pressed since the previous latch, counted at the next one
+  u64 taps;
+  u64 taps_sub_frame;  // released again before that latch
+  u64 taps_lost;  // of those, with tap capture off
+
+  // handovers when the active device leaves; timed until the next one is
+  // published, under g_device_mutex
+  u64 failovers;
+  s64 failover_ns_last;
+  s64 failover_ns_max;
+
+  // TAS playback: one of these per latch once a movie has started
+  u64 tas_frames;
+  u64 tas_underruns;  // the ring was empty
+
+  // with edge_histogram, the poll engine's time from the sample before a
+  // latch or clock edge to driving the data line, a bound on its response;
+  // the irq engine can't see when the edge arrived and records nothing
+  u64 edge_ns[UGC_EDGE_BUCKETS];
+
+  // interposer: age of the pad report answered at each latch
+  u64 pad_reports;
+  u64 pad_reports_stale;  // the read for this frame hadn't completed
+  u64 pad_reports_unread;  // no read had completed at all; no age recorded
+  s64 pad_age_ns_last;
+  s64 pad_age_ns_min;
+  s64 pad_age_ns_max;
+  s64 pad_age_ns_total;
+  s64 latch_period_ns;  // predicted
+};
+
+extern struct Stats g_stats;
+
+static inline void Stats_RecordEdge(u64 ns) {
+  ++g_stats.edge_ns[min_t(unsigned int, fls64(ns >> 6),
+      UGC_EDGE_BUCKETS - 1)];
+}
+
+int Stats_Setup(void);
+void Stats_Release(void);
+// The module's debugfs directory, or NULL without debugfs.
+struct dentry* Stats_Directory(void);
+
+#endif  // INCLUDED_UGC_STATS_H_
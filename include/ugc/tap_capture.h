@@ -0,0 +1,32 @@
+#ifndef INCLUDED_UGC_TAP_CAPTURE_H_
+#define INCLUDED_UGC_TAP_CAPTURE_H_
+
+#include <linux/types.h>
+
+#include <ugc/snes_report.h>
+
+// Keeps taps shorter than a console frame. Devices flag each button they
+// newly press in a sticky word that the latch consumes, and a button's
+// policy decides what a tap is reported as:
+//   0: nothing beyond what is held at the latch (taps can be lost)
+//   1: pressed for at least the frame after it started
+//   N: pressed for at least N frames
+struct TapCapture {
+  u64 enabled;  // policy 1 or more
+  u64 extended;  // policy 2 or more
+  u64 holding;  // buttons still owed frames
+  u8 frames[UGC_REPORT_MAX_BITS];  // by report bit
+  u8 remaining[UGC_REPORT_MAX_BITS];
+};
+
+// frames holds the policy of each of format's buttons, in its button order;
+// a single value applies to them all, and none means 1.
+void TapCapture_Init(struct TapCapture *capture,
+    const struct SnesReportFormat *format, const unsigned int *frames,
+    unsigned int count);
+
+// Called from the latch with the held buttons and the taps since the last
+// latch; returns the buttons to report. Records tap stats.
+u64 TapCapture_Latch(struct TapCapture *capture, u64 pressed, u64 taps);
+
+#endif  // INCLUDED_UGC_TAP_CAPTURE_H_
@@ -0,0 +1,68 @@
+#ifndef INCLUDED_UGC_TAS_H_
+#define INCLUDED_UGC_TAS_H_
+
+#include <linux/types.h>
+
+// Layout of /dev/ugc_tas when mapped: this header, then the ring of
+// report words from offset UGC_TAS_RING_OFFSET. A movie is played one
+// report word per console latch:
+//
+//   fd = open("/dev/ugc_tas", O_RDWR);  // one player at a time
+//   ring = mmap(NULL, UGC_TAS_RING_OFFSET + size * 8,
+//       PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+//   frames = (__u64 *)((char *)ring + UGC_TAS_RING_OFFSET);
+//   frames[ring->head & (ring->size - 1)] = report;
+//   __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+//
+// or by write()ing whole report words, which blocks while the ring is
+// full. Playback starts with the first queued word and replaces devices'
+// buttons until the file is closed. poll() reports POLLOUT while the
+// ring holds no more than low_watermark words, to be refilled.
+#define UGC_TAS_RING_OFFSET 4096u
+// the most words a ring holds, 8 MiB of them
+#define UGC_TAS_MAX_FRAMES (1u << 20)
+
+struct UgcTasRing {
+  __u32 head;  // words queued; advanced by the player
+  __u32 tail;  // words played; advanced by the latch
+  __u32 size;  // ring capacity in words, a power of two
+  __u32 low_watermark;  // written by the player, size / 4 at open
+  __u32 underruns;  // latches after the start with nothing queued
+};
+
+#ifdef __KERNEL__
+
+#include <linux/irq_work.h>
+#include <linux/miscdevice.h>
+#include <linux/mutex.h>
+#include <linux/wait.h>
+
+struct Tas {
+  struct miscdevice misc;
+  struct UgcTasRing *ring;  // NULL while off
+  u64 *frames;
+  u32 mask;  // size - 1
+  u32 tail;  // the latch's own copy; the page is the player's to scribble
+  bool started;
+  unsigned long open;  // bit 0 while a player has it
+  struct mutex write_lock;
+  wait_queue_head_t wait;
+  struct irq_work wake;
+};
+
+// size is rounded up to a power of two, at most UGC_TAS_MAX_FRAMES; 0
+// leaves playback off.
+int Tas_Setup(struct Tas *tas, unsigned int size);
+void Tas_Release(struct Tas *tas);
+
+static inline bool Tas_IsPlaying(const struct Tas *tas) {
+  return test_bit(0, &tas->open);
+}
+
+// Called from the latch interrupt while playing; returns the buttons to
+// report in place of pressed.
+u64 Tas_Latch(struct Tas *tas, u64 pressed);
+
+#endif  // __KERNEL__
+
+#endif  // INCLUDED_UGC_TAS_H_
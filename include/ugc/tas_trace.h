@@ -0,0 +1,44 @@
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM ugc
+
+#if !defined(INCLUDED_UGC_TAS_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define INCLUDED_UGC_TAS_TRACE_H_
+
+#include <linux/tracepoint.h>
+
+// One per latch during playback: the ring index played and its word.
+TRACE_EVENT(ugc_tas_frame,
+  TP_PROTO(u32 index, u64 report),
+  TP_ARGS(index, report),
+  TP_STRUCT__entry(
+    __field(u32, index)
+    __field(u64, report)
+  ),
+  TP_fast_assign(
+    __entry->index = index;
+    __entry->report = report;
+  ),
+  TP_printk("index=%u report=%#llx", __entry->index, __entry->report)
+);
+
+// A latch that found the ring empty; index is the word it waited for.
+TRACE_EVENT(ugc_tas_underrun,
+  TP_PROTO(u32 index),
+  TP_ARGS(index),
+  TP_STRUCT__entry(
+    __field(u32, index)
+  ),
+  TP_fast_assign(
+    __entry->index = index;
+  ),
+  TP_printk("index=%u", __entry->index)
+);
+
+#endif  // INCLUDED_UGC_TAS_TRACE_H_
+
+// found through -I$(src)/include
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH ugc
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE tas_trace
+#include <trace/define_trace.h>
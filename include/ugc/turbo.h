@@ -0,0 +1,29 @@
+#ifndef INCLUDED_UGC_TURBO_H_
+#define INCLUDED_UGC_TURBO_H_
+
+#include <linux/types.h>
+
+#include <ugc/snes_report.h>
+
+// Autofire counted in latches, so it stays in phase with the game's
+// polling. A held turbo button reports pressed for its first N latches,
+// released for the next N, and so on. The released phases are kept as one
+// XOR mask over the report word, updated as the latches are counted.
+struct Turbo {
+  u64 buttons;  // report bits with turbo
+  u64 held;  // turbo buttons held at the last latch
+  u64 off;  // held buttons in a released phase
+  u8 frames[UGC_REPORT_MAX_BITS];  // latches per phase, by report bit
+  u8 remaining[UGC_REPORT_MAX_BITS];  // latches left in the current phase
+};
+
+// frames holds the phase length of each of format's buttons, in its button
+// order, with 0 for no turbo; count is 0 or format->num_buttons.
+void Turbo_Init(struct Turbo *turbo, const struct SnesReportFormat *format,
+    const unsigned int *frames, unsigned int count);
+
+// Called from the latch with the buttons to report; returns them with the
+// released phases masked out, and counts the latch.
+u64 Turbo_Latch(struct Turbo *turbo, u64 pressed);
+
+#endif  // INCLUDED_UGC_TURBO_H_
@@ -0,0 +1,44 @@
+// A layer: while L is held, A and B swap and L itself isn't sent. Report
+// bits are those of the standard format (see snes_report.c).
+//
+//   bpftool btf dump file /sys/kernel/btf/vmlinux format c > vmlinux.h
+//   clang -O2 -g -target bpf -c swap_layer.bpf.c -o swap_layer.bpf.o
+//   bpftool prog loadall swap_layer.bpf.o /sys/fs/bpf/ugc autoattach
+//
+// Without a console, load the module with mode=gamepad, feed it a uinput
+// pad and watch the "UGC Gamepad" device with evtest.
+#include "vmlinux.h"
+
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+// The fields used, relocated against the module's BTF at load.
+struct ugc_bpf_ctx {
+  __u64 report;
+} __attribute__((preserve_access_index));
+
+#define UGC_B (1ull << 0)
+#define UGC_A (1ull << 8)
+#define UGC_L (1ull << 10)
+
+extern void ugc_bpf_set_report(struct ugc_bpf_ctx *ctx, __u64 report)
+    __ksym;
+
+SEC("fmod_ret/ugc_bpf_frame")
+int BPF_PROG(swap_layer, struct ugc_bpf_ctx *ctx) {
+  __u64 report = ctx->report;
+  __u64 swapped = 0;
+  if (!(report & UGC_L)) {
+    return 0;
+  }
+  if (report & UGC_A) {
+    swapped |= UGC_B;
+  }
+  if (report & UGC_B) {
+    swapped |= UGC_A;
+  }
+  ugc_bpf_set_report(ctx, (report & ~(UGC_A | UGC_B | UGC_L)) | swapped);
+  return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
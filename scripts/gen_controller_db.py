@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Compiles data/controller_db.txt into the C table of controller_db.c.
+
+Usage: gen_controller_db.py <controller_db.txt> <controller_db_table.h>
+
+Entries are sorted by (vendor, product, version) for binary search, and each
+entry's bindings are compiled here into the same rule form BindingTable uses:
+inputs numbered by first appearance, one rule per distinct input combination,
+largest chords first.
+"""
+
+import re
+import shlex
+import sys
+
+# SNES joypad order; a rule's output is a mask over these.
+BUTTONS = ['B', 'Y', 'Select', 'Start', 'Up', 'Down', 'Left', 'Right',
+           'A', 'X', 'L', 'R']
+TYPES = {'KEY_': 'EV_KEY', 'BTN_': 'EV_KEY', 'ABS_': 'EV_ABS',
+         'REL_': 'EV_REL'}
+MAX_INPUTS = 50
+ANY_VERSION = '*'
+
+
+class DbError(Exception):
+    pass
+
+
+def parse_input(text):
+    match = re.fullmatch(r'((?:KEY|BTN|ABS|REL)_[A-Z0-9_]+)([+-]?)', text)
+    if not match:
+        raise DbError('bad input: %s' % text)
+    code, sign = match.groups()
+    event_type = TYPES[code[:4]]
+    if sign and event_type == 'EV_KEY':
+        raise DbError('keys take no direction: %s' % text)
+    return (event_type, code, sign != '-')
+
+
+def split_chord(chord):
+    # a trailing +/- is a direction, any other + joins inputs
+    return re.findall(r'(?:KEY|BTN|ABS|REL)_[A-Z0-9_]+[+-]?(?=\+|$)', chord)
+
+
+def parse_line(line):
+    fields = shlex.split(line)
+    if len(fields) < 3:
+        raise DbError('expected ids, name and bindings')
+    ids = fields[0].split(':')
+    if len(ids) != 3:
+        raise DbError('bad ids: %s' % fields[0])
+    vendor, product = (int(value, 16) for value in ids[:2])
+    version = None if ids[2] == ANY_VERSION else int(ids[2], 16)
+    inputs = []
+    rules = {}
+    for binding in fields[2:]:
+        button, _, chord = binding.partition('=')
+        if button not in BUTTONS or not chord:
+            raise DbError('bad binding: %s' % binding)
+        parts = split_chord(chord)
+        if '+'.join(parts) != chord:
+            raise DbError('bad chord: %s' % chord)
+        mask = 0
+        for text in parts:
+            item = parse_input(text)
+            if item not in inputs:
+                inputs.append(item)
+            mask |= 1 << inputs.index(item)
+        rules[mask] = rules.get(mask, 0) | (1 << BUTTONS.index(button))
+    if len(inputs) > MAX_INPUTS:
+        raise DbError('too many inputs')
+    ordered = sorted(rules.items(), key=lambda rule: -bin(rule[0]).count('1'))
+    return {
+        'vendor': vendor, 'product': product, 'version': version,
+        'name': fields[1], 'inputs': inputs, 'rules': ordered,
+    }
+
+
+def parse(path):
+    entries = []
+    with open(path) as db:
+        for number, line in enumerate(db, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            try:
+                entries.append(parse_line(line))
+            except (DbError, ValueError) as error:
+                raise SystemExit('%s:%d: %s' % (path, number, error))
+    entries.sort(key=lambda entry: (entry['vendor'], entry['product'],
+                                    entry['version'] is None,
+                                    entry['version'] or 0))
+    return entries
+
+
+def c_string(text):
+    return '"%s"' % text.replace('\\', '\\\\').replace('"', '\\"')
+
+
+def write(entries, path):
+    out = ['// Generated by scripts/gen_controller_db.py; do not edit.', '']
+    for index, entry in enumerate(entries):
+        out.append('static const struct ControllerDbInput kInputs%d[] = {'
+                   % index)
+        for event_type, code, positive in entry['inputs']:
+            out.append('  { %s, %s, %s },' % (event_type, code,
+                                             'true' if positive else 'false'))
+        out.append('};')
+        out.append('static const struct ControllerDbRule kRules%d[] = {'
+                   % index)
+        for inputs, output in entry['rules']:
+            out.append('  { %#xull, %#x },' % (inputs, output))
+        out.append('};')
+    out.append('')
+    out.append('static const struct ControllerDbEntry kControllerDb[] = {')
+    for index, entry in enumerate(entries):
+        any_version = entry['version'] is None
+        out.append('  { %#06x, %#06x, %#06x, %s, %s, %d, kInputs%d, %d, '
+                   'kRules%d },' % (
+                       entry['vendor'], entry['product'],
+                       entry['version'] or 0,
+                       'true' if any_version else 'false',
+                       c_string(entry['name']),
+                       len(entry['inputs']), index,
+                       len(entry['rules']), index))
+    out.append('};')
+    with open(path, 'w') as table:
+        table.write('\n'.join(out) + '\n')
+
+
+def main(argv):
+    if len(argv) != 3:
+        raise SystemExit(__doc__)
+    write(parse(argv[1]), argv[2])
+
+
+if __name__ == '__main__':
+    main(sys.argv)
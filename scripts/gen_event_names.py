@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Generates the event name tables of info_strings.c from the uapi headers.
+
+Usage: gen_event_names.py <input-event-codes.h> <input.h> <event_names_table.h>
+
+Emits one dense array per code space, indexed by code, and a FNV-1a hashed
+open-addressing index over every name for the reverse lookup. Every name
+resolves, including aliases (BTN_A, defined as BTN_SOUTH) and range markers
+(BTN_GAMEPAD). Only the dense arrays pick one name per code: the later plain
+definition wins, so BTN_GAMEPAD gives way to BTN_SOUTH, and aliases never
+replace the name they alias.
+"""
+
+import re
+import sys
+
+# (table, prefixes, event type of the codes or None, header index)
+TABLES = [
+    ('kEventNames', ['EV_'], None, 0),
+    ('kSynNames', ['SYN_'], 'EV_SYN', 0),
+    ('kKeyNames', ['KEY_', 'BTN_'], 'EV_KEY', 0),
+    ('kRelNames', ['REL_'], 'EV_REL', 0),
+    ('kAbsNames', ['ABS_'], 'EV_ABS', 0),
+    ('kMscNames', ['MSC_'], 'EV_MSC', 0),
+    ('kSwNames', ['SW_'], 'EV_SW', 0),
+    ('kLedNames', ['LED_'], 'EV_LED', 0),
+    ('kSndNames', ['SND_'], 'EV_SND', 0),
+    ('kRepNames', ['REP_'], 'EV_REP', 0),
+    ('kFfStatusNames', ['FF_STATUS_'], 'EV_FF_STATUS', 1),
+    ('kFfNames', ['FF_'], 'EV_FF', 1),
+    ('kBusNames', ['BUS_'], None, 1),
+]
+SKIP = re.compile(r'_(MAX|CNT)$|^EV_VERSION$|^SW_MAX_$')
+DEFINE = re.compile(
+    r'^#define\s+([A-Z][A-Z0-9_]*)\s+(0x[0-9a-fA-F]+\b|\d+\b|[A-Z][A-Z0-9_]*$)')
+
+FNV_OFFSET = 0x811c9dc5
+FNV_PRIME = 0x01000193
+
+
+def fnv1a(text):
+    value = FNV_OFFSET
+    for byte in text.encode():
+        value = ((value ^ byte) * FNV_PRIME) & 0xffffffff
+    return value
+
+
+def read_defines(path):
+    """Returns (name, value, is_alias) in header order, aliases resolved."""
+    defines = []
+    values = {}
+    with open(path) as header:
+        for line in header:
+            match = DEFINE.match(line.strip())
+            if not match:
+                continue
+            name, value = match.groups()
+            is_alias = not value[0].isdigit()
+            if is_alias:
+                if value not in values:
+                    continue
+                value = values[value]
+            else:
+                value = int(value, 0)
+            values[name] = value
+            if not SKIP.search(name):
+                defines.append((name, value, is_alias))
+    return defines
+
+
+def build_tables(headers):
+    tables = []
+    claimed = set()
+    for name, prefixes, event_type, header in TABLES:
+        codes = {}
+        names = []
+        for define, value, is_alias in headers[header]:
+            if define in claimed or not define.startswith(tuple(prefixes)):
+                continue
+            names.append(define)
+            if not is_alias:
+                codes[value] = define
+        claimed.update(names)
+        tables.append((name, event_type, codes, names))
+    return tables
+
+
+def write(tables, path):
+    out = ['// Generated by scripts/gen_event_names.py; do not edit.', '']
+    names = []
+    for name, event_type, codes, all_names in tables:
+        out.append('static const char * const %s[%d] = {'
+                   % (name, max(codes) + 1))
+        for code in sorted(codes):
+            out.append('  [%s] = "%s",' % (codes[code], codes[code]))
+        out.append('};')
+        if event_type:
+            names.extend((define, event_type) for define in all_names)
+    size = 1
+    while size < 2 * len(names):
+        size *= 2
+    slots = [0] * size
+    for index, (name, _) in enumerate(names):
+        slot = fnv1a(name) & (size - 1)
+        while slots[slot]:
+            slot = (slot + 1) & (size - 1)
+        slots[slot] = index + 1
+    out.append('')
+    out.append('static const struct EventCodeName kEventCodeNames[] = {')
+    for name, event_type in names:
+        out.append('  { "%s", %s, %s },' % (name, event_type, name))
+    out.append('};')
+    out.append('')
+    out.append('// 1 + index into kEventCodeNames; 0 is an empty slot')
+    out.append('static const u16 kEventCodeNameHash[%d] = {' % size)
+    for start in range(0, size, 12):
+        out.append('  ' + ', '.join(str(slot)
+                                    for slot in slots[start:start + 12]) + ',')
+    out.append('};')
+    with open(path, 'w') as table:
+        table.write('\n'.join(out) + '\n')
+
+
+def main(argv):
+    if len(argv) != 4:
+        raise SystemExit(__doc__)
+    headers = [read_defines(argv[1]), read_defines(argv[2])]
+    write(build_tables(headers), argv[3])
+
+
+if __name__ == '__main__':
+    main(sys.argv)
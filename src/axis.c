@@ -0,0 +1,90 @@
+#include <ugc/axis.h>
+
+#include <linux/kernel.h>  // max, S32_MIN
+#include <linux/math64.h>
+
+static bool is_trigger(unsigned int code, const struct input_absinfo *absinfo,
+    bool dual_stick) {
+  switch (code) {
+    case ABS_Z:
+    case ABS_RZ:
+      // generic HID pads put their right stick here, unsigned
+      return dual_stick && absinfo->minimum >= 0;
+    case ABS_THROTTLE:
+    case ABS_RUDDER:
+    case ABS_GAS:
+    case ABS_BRAKE:
+      // signed ranges are sticks
+      return absinfo->minimum >= 0;
+  }
+  return false;
+}
+
+// Distance from the center for percent of travel; at least the flat, and
+// at least 1 so a hat presses at +-1.
+static s32 Axis_Offset(const struct Axis *axis, s64 travel,
+    unsigned int percent) {
+  const u64 offset = div_u64((u64)travel * percent + 99, 100);
+  return (s32)max_t(u64, offset, max_t(u64, axis->flat, 1));
+}
+
+// Q16 quantization steps per unit of travel; 0 without travel.
+static u32 Axis_Scale(s64 travel) {
+  return travel > 0 ? (u32)div64_u64((u64)UGC_AXIS_QUANTA << 16, travel) : 0;
+}
+
+static void Axis_Compute(struct Axis *axis) {
+  const s64 low = (s64)axis->center - axis->minimum;
+  const s64 high = (s64)axis->maximum - axis->center;
+  axis->scale_low = Axis_Scale(low);
+  axis->scale_high = Axis_Scale(high);
+  if (low > 0) {
+    axis->press_low = axis->center - Axis_Offset(axis, low,
+        axis->press_percent);
+    axis->release_low = axis->center - Axis_Offset(axis, low,
+        axis->release_percent);
+  } else {
+    // nothing below the center; never pressed
+    axis->press_low = S32_MIN;
+    axis->release_low = S32_MIN;
+  }
+  if (high > 0) {
+    axis->press_high = axis->center + Axis_Offset(axis, high,
+        axis->press_percent);
+    axis->release_high = axis->center + Axis_Offset(axis, high,
+        axis->release_percent);
+  } else {
+    axis->press_high = S32_MAX;
+    axis->release_high = S32_MAX;
+  }
+}
+
+void Axis_Init(struct Axis *axis, unsigned int code,
+    const struct input_absinfo *absinfo, unsigned int press_percent,
+    unsigned int release_percent, bool dual_stick) {
+  *axis = (struct Axis) {
+    .minimum = absinfo->minimum,
+    .maximum = absinfo->maximum,
+    .flat = clamp_t(s32, absinfo->flat, 0, U16_MAX),
+    .value = absinfo->value,
+    .press_percent = press_percent,
+    .release_percent = release_percent,
+  };
+  if (is_trigger(code, absinfo, dual_stick)) {
+    axis->center = absinfo->minimum;
+  } else {
+    axis->center = (s32)div_s64((s64)absinfo->minimum + absinfo->maximum,
+        2);
+  }
+  Axis_Compute(axis);
+}
+
+void Axis_Calibrate(struct Axis *axis, s32 value) {
+  // the center stays put; only the travel on that side grows
+  if (value < axis->minimum) {
+    axis->minimum = value;
+  } else if (value > axis->maximum) {
+    axis->maximum = value;
+  }
+  Axis_Compute(axis);
+}
@@ -0,0 +1,43 @@
+#include <ugc/binding_table.h>
+
+#include <linux/bitops.h>  // hweight64
+#include <linux/sort.h>
+
+void BindingTable_Init(struct BindingTable *table) {
+  table->num_rules = 0;
+}
+
+bool BindingTable_Add(struct BindingTable *table, u64 inputs, u64 output) {
+  unsigned int i;
+  for (i = 0; i < table->num_rules; ++i) {
+    if (table->rule[i].inputs == inputs) {
+      table->rule[i].output |= output;
+      return true;
+    }
+  }
+  if (table->num_rules == UGC_MAX_RULES) {
+    return false;
+  }
+  table->rule[table->num_rules++] = (struct BindingRule) {
+    .inputs = inputs,
+    .output = output,
+  };
+  return true;
+}
+
+static int BindingRule_CompareSize(const void *lhs, const void *rhs) {
+  // larger chords first
+  return hweight64(((const struct BindingRule *)rhs)->inputs) -
+      hweight64(((const struct BindingRule *)lhs)->inputs);
+}
+
+void BindingTable_Compile(struct BindingTable *table) {
+  unsigned int i;
+  sort(table->rule, table->num_rules, sizeof(table->rule[0]),
+      BindingRule_CompareSize, NULL);
+  for (i = 0; i < table->num_rules; ++i) {
+    struct BindingRule *rule = table->rule + i;
+    // only chords consume; a single input may fan out through one rule
+    rule->consumes = (hweight64(rule->inputs) > 1) ? rule->inputs : 0;
+  }
+}
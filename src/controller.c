@@ -0,0 +1,126 @@
+#include <ugc/controller.h>
+
+#include <linux/slab.h>
+
+int Controller_Init(struct Controller *controller, enum MergePolicy policy) {
+  struct ControllerMembers *members = kzalloc(sizeof(*members), GFP_KERNEL);
+  if (!members) {
+    return -ENOMEM;
+  }
+  controller->policy = policy;
+  spin_lock_init(&controller->lock);
+  RCU_INIT_POINTER(controller->members, members);
+  return 0;
+}
+
+void Controller_Release(struct Controller *controller) {
+  // callers have stopped the latch interrupt
+  kfree(rcu_dereference_protected(controller->members, true));
+  RCU_INIT_POINTER(controller->members, NULL);
+}
+
+static void Controller_UpdateMasks(enum MergePolicy policy,
+    struct ControllerMembers *members) {
+  u64 claimed = 0;
+  unsigned int i;
+  for (i = 0; i < members->count; ++i) {
+    struct ControllerMember *member = members->member + i;
+    member->mask = member->bound;
+    if (policy == kMergePriority) {
+      member->mask &= ~claimed;
+      claimed |= member->bound;
+    }
+  }
+}
+
+// Called with controller->lock held; published is the set being replaced.
+static void Controller_Publish(struct Controller *controller,
+    struct ControllerMembers *members, struct ControllerMembers *published) {
+  Controller_UpdateMasks(controller->policy, members);
+  rcu_assign_pointer(controller->members, members);
+  kfree_rcu(published, rcu);
+}
+
+int Controller_Add(struct Controller *controller, const atomic64_t *report,
+    atomic64_t *taps, u64 bound) {
+  struct ControllerMembers *published, *members;
+  unsigned long flags;
+  int result = 0;
+
+  // allocated up front so the lock is never held across an allocation
+  members = kmalloc(sizeof(*members), GFP_ATOMIC);
+  if (!members) {
+    return -ENOMEM;
+  }
+  spin_lock_irqsave(&controller->lock, flags);
+  published = rcu_dereference_protected(controller->members,
+      lockdep_is_held(&controller->lock));
+  if (controller->policy == kMergeReplace) {
+    members->count = 0;
+  } else if (published->count == UGC_MAX_MEMBERS) {
+    result = -ENOSPC;
+    goto err_unlock;
+  } else {
+    *members = *published;
+  }
+  members->member[members->count++] = (struct ControllerMember) {
+    .report = report,
+    .taps = taps,
+    .bound = bound,
+  };
+  Controller_Publish(controller, members, published);
+  spin_unlock_irqrestore(&controller->lock, flags);
+  return 0;
+
+err_unlock:
+  spin_unlock_irqrestore(&controller->lock, flags);
+  kfree(members);
+  return result;
+}
+
+int Controller_Update(struct Controller *controller, const atomic64_t *report,
+    u64 bound) {
+  struct ControllerMembers *published, *members;
+  unsigned long flags;
+  unsigned int i;
+
+  members = kmalloc(sizeof(*members), GFP_ATOMIC);
+  if (!members) {
+    return -ENOMEM;
+  }
+  spin_lock_irqsave(&controller->lock, flags);
+  published = rcu_dereference_protected(controller->members,
+      lockdep_is_held(&controller->lock));
+  *members = *published;
+  for (i = 0; i < members->count; ++i) {
+    if (members->member[i].report == report) {
+      members->member[i].bound = bound;
+      Controller_Publish(controller, members, published);
+      spin_unlock_irqrestore(&controller->lock, flags);
+      return 0;
+    }
+  }
+  spin_unlock_irqrestore(&controller->lock, flags);
+  kfree(members);
+  return -ENOENT;
+}
+
+void Controller_Remove(struct Controller *controller,
+    const atomic64_t *report) {
+  struct ControllerMembers *published, *members;
+  unsigned long flags;
+  unsigned int i;
+
+  members = kmalloc(sizeof(*members), GFP_KERNEL | __GFP_NOFAIL);
+  spin_lock_irqsave(&controller->lock, flags);
+  published = rcu_dereference_protected(controller->members,
+      lockdep_is_held(&controller->lock));
+  members->count = 0;
+  for (i = 0; i < published->count; ++i) {
+    if (published->member[i].report != report) {
+      members->member[members->count++] = published->member[i];
+    }
+  }
+  Controller_Publish(controller, members, published);
+  spin_unlock_irqrestore(&controller->lock, flags);
+}
@@ -0,0 +1,84 @@
+#include <ugc/controller_db.h>
+
+#include <linux/input.h>
+#include <linux/kernel.h>  // ARRAY_SIZE
+
+// Generated from data/controller_db.txt at build time.
+#include "controller_db_table.h"
+
+static int ControllerDbEntry_Compare(const struct ControllerDbEntry *entry,
+    u16 vendor, u16 product) {
+  if (entry->vendor != vendor) {
+    return entry->vendor < vendor ? -1 : 1;
+  }
+  if (entry->product != product) {
+    return entry->product < product ? -1 : 1;
+  }
+  return 0;
+}
+
+const struct ControllerDbEntry *ControllerDb_Find(u16 vendor, u16 product,
+    u16 version) {
+  const struct ControllerDbEntry *entry;
+  size_t low = 0, high = ARRAY_SIZE(kControllerDb);
+  // lower bound of (vendor, product)
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (ControllerDbEntry_Compare(kControllerDb + middle, vendor,
+        product) < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  // exact versions sort ahead of the wildcard
+  for (entry = kControllerDb + low;
+      entry != kControllerDb + ARRAY_SIZE(kControllerDb) &&
+      ControllerDbEntry_Compare(entry, vendor, product) == 0;
+      ++entry) {
+    if (entry->any_version || entry->version == version) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+void ControllerDb_ToProfile(const struct ControllerDbEntry *entry,
+    const struct SnesReportFormat *format, struct Profile *profile) {
+  const struct SnesReportFormat *joypad = SnesReportFormat_Find("standard");
+  u64 button_mask[16] = { 0 };
+  unsigned int i, j;
+
+  // match the joypad's buttons to the format's by evdev code
+  for (i = 0; i < joypad->num_buttons; ++i) {
+    for (j = 0; j < format->num_buttons; ++j) {
+      if (format->button_code[j] == joypad->button_code[i]) {
+        button_mask[i] = SnesReportFormat_ButtonMask(format, j);
+        break;
+      }
+    }
+  }
+  profile->num_inputs = entry->num_inputs;
+  for (i = 0; i < entry->num_inputs; ++i) {
+    profile->input[i] = (struct ProfileInput) {
+      .type = entry->inputs[i].type,
+      .code = entry->inputs[i].code,
+      .positive = entry->inputs[i].positive,
+    };
+  }
+  profile->num_banks = 1;
+  BindingTable_Init(profile->banks);
+  for (i = 0; i < entry->num_rules; ++i) {
+    const struct ControllerDbRule *rule = entry->rules + i;
+    u64 output = 0;
+    for (j = 0; j < joypad->num_buttons; ++j) {
+      if (rule->output & BIT(j)) {
+        output |= button_mask[j];
+      }
+    }
+    if (output) {
+      BindingTable_Add(profile->banks, rule->inputs, output);
+    }
+  }
+  BindingTable_Compile(profile->banks);
+}
@@ -49,6 +49,19 @@ void ControllerId_Set(struct ControllerId* id, const char* name,
 
 void ControllerId_Populate(struct ControllerId* id,
     struct input_handle *handle) {
-  ControllerId_Set(id, handle->dev->name, handle->dev->uniq,
-      handle->dev->phys, handle->dev->id.bustype);
+  ControllerId_PopulateFromDev(id, handle->dev);
+}
+
+void ControllerId_PopulateFromDev(struct ControllerId* id,
+    struct input_dev *dev) {
+  ControllerId_Set(id, dev->name, dev->uniq, dev->phys, dev->id.bustype);
+}
+
+// Missing strings are stored as empty ones, so they compare equal too.
+bool ControllerId_Equal(const struct ControllerId* lhs,
+    const struct ControllerId* rhs) {
+  return lhs->bustype == rhs->bustype &&
+      strcmp(lhs->name, rhs->name) == 0 &&
+      strcmp(lhs->uniq, rhs->uniq) == 0 &&
+      strcmp(lhs->phys, rhs->phys) == 0;
 }
@@ -0,0 +1,88 @@
+#include <ugc/dpad.h>
+
+#include <linux/errno.h>
+#include <linux/input.h>
+#include <linux/kernel.h>
+
+// tan(degrees) * 1024, for 0 to 45 degrees
+static const u16 kTan1024[] = {
+  0, 18, 36, 54, 72, 90, 108, 126, 144, 162, 181, 199, 218, 236, 255, 274,
+  294, 313, 333, 353, 373, 393, 414, 435, 456, 477, 499, 522, 544, 568, 591,
+  615, 640, 665, 691, 717, 744, 772, 800, 829, 859, 890, 922, 955, 989, 1024
+};
+
+static u64 button_bits(const struct SnesReportFormat *format,
+    unsigned int code) {
+  unsigned int i;
+  for (i = 0; i < format->num_buttons; ++i) {
+    if (format->button_code[i] == code) {
+      return SnesReportFormat_ButtonMask(format, i);
+    }
+  }
+  return 0;
+}
+
+void DpadBits_Init(struct DpadBits *dpad,
+    const struct SnesReportFormat *format) {
+  const u64 up = button_bits(format, BTN_DPAD_UP);
+  const u64 down = button_bits(format, BTN_DPAD_DOWN);
+  const u64 left = button_bits(format, BTN_DPAD_LEFT);
+  const u64 right = button_bits(format, BTN_DPAD_RIGHT);
+  unsigned int i;
+  for (i = 0; i < UGC_DPAD_COMBINATIONS; ++i) {
+    dpad->bits[i] = (i & UGC_DPAD_UP ? up : 0) |
+        (i & UGC_DPAD_DOWN ? down : 0) |
+        (i & UGC_DPAD_LEFT ? left : 0) |
+        (i & UGC_DPAD_RIGHT ? right : 0);
+  }
+}
+
+int StickDpad_Init(struct StickDpad *stick, unsigned int ways,
+    unsigned int diagonal_degrees, unsigned int deadzone_percent) {
+  // a cell is diagonal when its minor/major ratio is past this tangent
+  unsigned int cardinal_tan;
+  int deadzone;
+  int row, column;
+  if ((ways != 4 && ways != 8) || diagonal_degrees > 90 ||
+      deadzone_percent > 100) {
+    return -EINVAL;
+  }
+  cardinal_tan = ways == 4 ? kTan1024[45] :
+      kTan1024[(90 - diagonal_degrees) / 2];
+  // cell centers are at odd coordinates, so the radius is 2 * quanta
+  deadzone = 2 * UGC_AXIS_QUANTA * deadzone_percent / 100;
+  for (row = 0; row < UGC_STICK_STEPS; ++row) {
+    for (column = 0; column < UGC_STICK_STEPS; ++column) {
+      const int x = 2 * (column - UGC_AXIS_QUANTA) + 1;
+      const int y = 2 * (row - UGC_AXIS_QUANTA) + 1;
+      const unsigned int major = max(abs(x), abs(y));
+      const unsigned int minor = min(abs(x), abs(y));
+      const unsigned int horizontal = x < 0 ? UGC_DPAD_LEFT : UGC_DPAD_RIGHT;
+      // evdev's Y grows downwards
+      const unsigned int vertical = y < 0 ? UGC_DPAD_UP : UGC_DPAD_DOWN;
+      unsigned int direction;
+      if (x * x + y * y < deadzone * deadzone) {
+        direction = 0;
+      } else if (minor * 1024 > major * cardinal_tan) {
+        direction = horizontal | vertical;
+      } else if (abs(x) >= abs(y)) {
+        direction = horizontal;
+      } else {
+        direction = vertical;
+      }
+      stick->sector[row][column] = direction;
+    }
+  }
+  return 0;
+}
+
+void Socd_Init(struct Socd *socd, enum SocdPolicy policy,
+    const struct DpadBits *dpad) {
+  *socd = (struct Socd) {
+    .policy = policy,
+    .up = dpad->bits[UGC_DPAD_UP],
+    .down = dpad->bits[UGC_DPAD_DOWN],
+    .left = dpad->bits[UGC_DPAD_LEFT],
+    .right = dpad->bits[UGC_DPAD_RIGHT],
+  };
+}
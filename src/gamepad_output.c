@@ -0,0 +1,100 @@
+#include <ugc/gamepad_output.h>
+
+// Reports the buttons of report that differ from shadow, and a SYN_REPORT.
+static void GamepadOutput_Send(struct GamepadOutput *output, u64 report,
+    u64 shadow) {
+  const struct SnesReportFormat *format = output->format;
+  const u64 changed = report ^ shadow;
+  unsigned int i;
+  if (!changed) {
+    return;
+  }
+  for (i = 0; i < format->num_buttons; ++i) {
+    const u64 mask = SnesReportFormat_ButtonMask(format, i);
+    if (changed & mask) {
+      input_report_key(output->input, format->button_code[i],
+          (report & mask) != 0);
+    }
+  }
+  input_sync(output->input);
+}
+
+static void GamepadOutput_Emit(struct work_struct *work) {
+  struct GamepadOutput *output =
+      container_of(work, struct GamepadOutput, emit);
+  unsigned long flags;
+  u64 report, shadow, taps;
+
+  // the work item never runs twice at once, so events stay in order
+  spin_lock_irqsave(&output->lock, flags);
+  report = output->report;
+  shadow = output->shadow;
+  taps = output->taps & ~shadow & ~report;
+  output->shadow = report;
+  output->taps = 0;
+  spin_unlock_irqrestore(&output->lock, flags);
+  if (taps) {
+    GamepadOutput_Send(output, shadow | taps, shadow);
+    shadow |= taps;
+  }
+  GamepadOutput_Send(output, report, shadow);
+}
+
+int GamepadOutput_Setup(struct GamepadOutput *output,
+    const struct SnesReportFormat *format) {
+  struct input_dev *input;
+  unsigned int i;
+  int result;
+
+  input = input_allocate_device();
+  if (!input) {
+    return -ENOMEM;
+  }
+  input->name = "UGC Gamepad";
+  input->phys = "ugc/gamepad0";
+  input->id.bustype = BUS_VIRTUAL;
+  __set_bit(EV_KEY, input->evbit);
+  for (i = 0; i < format->num_buttons; ++i) {
+    __set_bit(format->button_code[i], input->keybit);
+  }
+  output->format = format;
+  output->report = 0;
+  output->taps = 0;
+  output->shadow = 0;
+  spin_lock_init(&output->lock);
+  INIT_WORK(&output->emit, GamepadOutput_Emit);
+  // set before registering so the handler can recognize and skip it
+  output->input = input;
+  result = input_register_device(input);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("Gamepad registration failed with code: %d\n"),
+        result);
+    output->input = NULL;
+    input_free_device(input);
+    return result;
+  }
+  return 0;
+}
+
+void GamepadOutput_Release(struct GamepadOutput *output) {
+  if (output->input) {
+    // no device is left to commit
+    cancel_work_sync(&output->emit);
+    input_unregister_device(output->input);
+    output->input = NULL;
+  }
+}
+
+void GamepadOutput_Commit(struct GamepadOutput *output, u64 report) {
+  unsigned long flags;
+  bool changed;
+
+  spin_lock_irqsave(&output->lock, flags);
+  changed = report != output->report;
+  output->report = report;
+  output->taps |= report;
+  spin_unlock_irqrestore(&output->lock, flags);
+  if (changed) {
+    queue_work(system_highpri_wq, &output->emit);
+  }
+}
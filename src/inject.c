@@ -0,0 +1,85 @@
+#include <ugc/inject.h>
+
+#include <linux/fs.h>
+#include <linux/gfp.h>
+#include <linux/mm.h>
+
+static struct Inject *Inject_FromFile(struct file *file) {
+  // misc_open points private_data at the miscdevice
+  return container_of(file->private_data, struct Inject, misc);
+}
+
+static int Inject_Open(struct inode *inode, struct file *file) {
+  atomic_inc(&Inject_FromFile(file)->openers);
+  return 0;
+}
+
+static int Inject_Close(struct inode *inode, struct file *file) {
+  struct Inject *inject = Inject_FromFile(file);
+  struct UgcInjectPage *page = inject->page;
+  if (atomic_dec_and_test(&inject->openers)) {
+    // nobody is left to release what was held
+    WRITE_ONCE(page->mask, 0);
+    WRITE_ONCE(page->report, 0);
+    WRITE_ONCE(page->taps, 0);
+  }
+  return 0;
+}
+
+static int Inject_Mmap(struct file *file, struct vm_area_struct *vma) {
+  if (vma->vm_pgoff != 0 || vma->vm_end - vma->vm_start != PAGE_SIZE) {
+    return -EINVAL;
+  }
+  // a private mapping's writes would go to a copy the latch never reads
+  if (!(vma->vm_flags & VM_SHARED)) {
+    return -EINVAL;
+  }
+  return vm_insert_page(vma, vma->vm_start,
+      virt_to_page(Inject_FromFile(file)->page));
+}
+
+static const struct file_operations kInjectFops = {
+  .owner = THIS_MODULE,
+  .open = Inject_Open,
+  .release = Inject_Close,
+  .mmap = Inject_Mmap,
+  .llseek = noop_llseek,
+};
+
+int Inject_Setup(struct Inject *inject, enum InjectPolicy policy) {
+  int result;
+  if (policy == kInjectOff) {
+    return 0;
+  }
+  inject->page = (struct UgcInjectPage *)get_zeroed_page(GFP_KERNEL);
+  if (!inject->page) {
+    return -ENOMEM;
+  }
+  atomic_set(&inject->openers, 0);
+  inject->misc = (struct miscdevice) {
+    .minor = MISC_DYNAMIC_MINOR,
+    .name = "ugc_inject",
+    .fops = &kInjectFops,
+    .mode = 0600,
+  };
+  result = misc_register(&inject->misc);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("Inject registration failed with code: %d\n"),
+        result);
+    free_page((unsigned long)inject->page);
+    inject->page = NULL;
+    return result;
+  }
+  inject->policy = policy;
+  return 0;
+}
+
+void Inject_Release(struct Inject *inject) {
+  if (!inject->page) {
+    return;
+  }
+  misc_deregister(&inject->misc);
+  free_page((unsigned long)inject->page);
+  inject->page = NULL;
+  inject->policy = kInjectOff;
+}
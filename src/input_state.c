@@ -12,7 +12,7 @@ int InputState_Compare(const struct InputState *lhs,
   if (diff) {
     return diff;
   }
-  return (lhs->positive - lhs->positive);
+  return (lhs->positive - rhs->positive);
 }
 
 struct InputState *InputState_Search(struct rb_root *root,
@@ -0,0 +1,74 @@
+#include <ugc/interposer.h>
+
+#include <ugc/stats.h>
+
+#include <linux/math64.h>
+
+// Latch periods outside of this are a console reset or a game that stopped
+// polling, and restart the prediction. NTSC and PAL are ~16.6ms and 20ms.
+#define UGC_MIN_LATCH_PERIOD_NS (5 * NSEC_PER_MSEC)
+#define UGC_MAX_LATCH_PERIOD_NS (50 * NSEC_PER_MSEC)
+
+void Interposer_Init(struct Interposer *interposer,
+    struct PadReader *reader, ktime_t lead) {
+  *interposer = (struct Interposer) {
+    .reader = reader,
+    .lead = lead,
+  };
+}
+
+static void Interposer_Record(struct Interposer *interposer, ktime_t now) {
+  const s64 completed_ns = atomic64_read(&interposer->reader->completed_ns);
+  const s64 age_ns = ktime_to_ns(now) - completed_ns;
+  struct Stats *stats = &g_stats;
+  ++stats->pad_reports;
+  if (completed_ns <= ktime_to_ns(interposer->last_latch)) {
+    ++stats->pad_reports_stale;
+  }
+  if (!completed_ns) {
+    // no read has completed yet; an age since boot would skew the rest
+    ++stats->pad_reports_unread;
+    return;
+  }
+  stats->pad_age_ns_last = age_ns;
+  stats->pad_age_ns_total += age_ns;
+  if (age_ns < stats->pad_age_ns_min) {
+    stats->pad_age_ns_min = age_ns;
+  }
+  if (age_ns > stats->pad_age_ns_max) {
+    stats->pad_age_ns_max = age_ns;
+  }
+}
+
+u64 Interposer_Latch(struct Interposer *interposer, ktime_t now) {
+  struct PadReader *reader = interposer->reader;
+  const u64 report = atomic64_read(&reader->report);
+  const s64 period_ns = ktime_to_ns(ktime_sub(now, interposer->last_latch));
+  ktime_t start = now;
+
+  Interposer_Record(interposer, now);
+  if (period_ns < UGC_MIN_LATCH_PERIOD_NS ||
+      period_ns > UGC_MAX_LATCH_PERIOD_NS) {
+    interposer->period_ns = 0;
+  } else if (!interposer->period_ns) {
+    interposer->period_ns = period_ns;
+  } else {
+    // moving average, 1/8 weight to the newest period
+    interposer->period_ns += div_s64(period_ns - interposer->period_ns, 8);
+  }
+  interposer->last_latch = now;
+  g_stats.latch_period_ns = interposer->period_ns;
+
+  // Without a prediction, read now so the next frame is at most a frame
+  // old; with one, finish just ahead of the next latch.
+  if (interposer->period_ns) {
+    const ktime_t predicted = ktime_sub(
+        ktime_add_ns(now, interposer->period_ns),
+        ktime_add(interposer->lead, PadReader_ReadDuration(reader)));
+    if (ktime_after(predicted, now)) {
+      start = predicted;
+    }
+  }
+  PadReader_Schedule(reader, start);
+  return report;
+}
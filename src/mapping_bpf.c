@@ -0,0 +1,61 @@
+#include <ugc/mapping_bpf.h>
+
+#ifdef UGC_HAS_MAPPING_BPF
+
+#include <ugc/input_state.h>
+
+#include <linux/bpf.h>
+#include <linux/btf.h>
+#include <linux/btf_ids.h>
+#include <linux/error-injection.h>
+#include <linux/module.h>
+
+// The attach point. Error injection listing is what lets fmod_ret
+// programs attach; they run in place of this body.
+__weak noinline int ugc_bpf_frame(struct ugc_bpf_ctx *ctx) {
+  return 0;
+}
+ALLOW_ERROR_INJECTION(ugc_bpf_frame, ERRNO);
+
+__bpf_kfunc_start_defs();
+
+__bpf_kfunc void ugc_bpf_set_report(struct ugc_bpf_ctx *ctx, u64 report) {
+  ctx->report = report;
+  ctx->replaced = true;
+}
+
+__bpf_kfunc int ugc_bpf_input_bit(struct ugc_bpf_ctx *ctx, u32 type,
+    u32 code, bool positive) {
+  struct InputState key = {
+    .type = type,
+    .code = code,
+    .positive = positive,
+  };
+  const struct InputState *node = InputState_Search(ctx->inputs, &key);
+  return node ? node->value : -ENOENT;
+}
+
+__bpf_kfunc_end_defs();
+
+BTF_KFUNCS_START(kMappingBpfKfuncIds)
+BTF_ID_FLAGS(func, ugc_bpf_set_report)
+BTF_ID_FLAGS(func, ugc_bpf_input_bit)
+BTF_KFUNCS_END(kMappingBpfKfuncIds)
+
+static const struct btf_kfunc_id_set kMappingBpfKfuncs = {
+  .owner = THIS_MODULE,
+  .set = &kMappingBpfKfuncIds,
+};
+
+int MappingBpf_Setup(void) {
+  return register_btf_kfunc_id_set(BPF_PROG_TYPE_TRACING,
+      &kMappingBpfKfuncs);
+}
+
+u64 MappingBpf_Frame(struct ugc_bpf_ctx *ctx) {
+  ctx->replaced = false;
+  ugc_bpf_frame(ctx);
+  return ctx->report;
+}
+
+#endif  // UGC_HAS_MAPPING_BPF
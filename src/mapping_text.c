@@ -0,0 +1,201 @@
+#include <ugc/mapping_text.h>
+
+#include <ugc/info_strings.h>
+
+#include <linux/ctype.h>
+#include <linux/errno.h>
+#include <linux/input.h>
+#include <linux/kernel.h>  // kstrtouint
+#include <linux/string.h>
+
+#define UGC_BANK_SEPARATOR "---"
+#define UGC_MAX_NUMBER_LENGTH 15
+
+static bool is_input_char(char c) {
+  return isalnum(c) || c == '_' || c == ':';
+}
+
+static int parse_number(const char* text, size_t length, unsigned int* value) {
+  char buffer[UGC_MAX_NUMBER_LENGTH + 1];
+  if (length == 0 || length > UGC_MAX_NUMBER_LENGTH) {
+    return -EINVAL;
+  }
+  memcpy(buffer, text, length);
+  buffer[length] = '\0';
+  return kstrtouint(buffer, 0, value);
+}
+
+// Resolves a code name, or a type:code pair when built without name tables.
+static int MappingText_ParseCode(const char* text, size_t length,
+    struct ProfileInput* input) {
+  const char* colon = memchr(text, ':', length);
+  int result;
+  if (colon) {
+    result = parse_number(text, colon - text, &input->type);
+    if (result == 0) {
+      result = parse_number(colon + 1, text + length - colon - 1,
+          &input->code);
+    }
+  } else {
+    result = GetEventCode(text, length, &input->type, &input->code);
+  }
+  if (result != 0) {
+    return result;
+  }
+  switch (input->type) {
+    case EV_KEY:
+      return input->code <= KEY_MAX ? 0 : -EINVAL;
+    case EV_REL:
+      return input->code <= REL_MAX ? 0 : -EINVAL;
+    case EV_ABS:
+      return input->code <= ABS_MAX ? 0 : -EINVAL;
+  }
+  return -EINVAL;
+}
+
+// Parses one input of a chord, returning where it ends or NULL. A trailing
+// + is a direction only when nothing but another + follows it; any other +
+// joins inputs.
+static const char* MappingText_ParseInput(const char* at, const char* end,
+    struct ProfileInput* input) {
+  const char* const start = at;
+  bool has_direction = false;
+  while (at != end && is_input_char(*at)) {
+    ++at;
+  }
+  if (MappingText_ParseCode(start, at - start, input) != 0) {
+    return NULL;
+  }
+  input->positive = true;
+  if (at != end && *at == '-') {
+    input->positive = false;
+    has_direction = true;
+    ++at;
+  } else if (at != end && *at == '+' && (at + 1 == end || at[1] == '+')) {
+    has_direction = true;
+    ++at;
+  }
+  if (has_direction && input->type == EV_KEY) {
+    return NULL;
+  }
+  return at;
+}
+
+// Returns the raw bit of input, adding it when new; -1 if out of space.
+static int MappingText_InputIndex(struct Profile* profile,
+    const struct ProfileInput* input) {
+  unsigned int i;
+  for (i = 0; i < profile->num_inputs; ++i) {
+    const struct ProfileInput* other = profile->input + i;
+    if (other->type == input->type && other->code == input->code &&
+        other->positive == input->positive) {
+      return i;
+    }
+  }
+  if (profile->num_inputs == UGC_MAX_INPUTS) {
+    return -1;
+  }
+  profile->input[profile->num_inputs] = *input;
+  return profile->num_inputs++;
+}
+
+static int MappingText_CompileBinding(const char* at, const char* end,
+    const struct SnesReportFormat* format, struct Profile* profile,
+    struct BindingTable* bank) {
+  const char* equals = memchr(at, '=', end - at);
+  int button;
+  u64 inputs = 0;
+  if (!equals || equals + 1 == end) {
+    return -EINVAL;
+  }
+  button = SnesReportFormat_FindButton(format, at, equals - at);
+  if (button < 0) {
+    return -EINVAL;
+  }
+  for (at = equals + 1; ; ++at) {
+    struct ProfileInput input;
+    int index;
+    at = MappingText_ParseInput(at, end, &input);
+    if (!at) {
+      return -EINVAL;
+    }
+    index = MappingText_InputIndex(profile, &input);
+    if (index < 0) {
+      return -ENOSPC;
+    }
+    inputs |= BIT_ULL(index);
+    if (at == end) {
+      break;
+    }
+    if (*at != '+') {
+      return -EINVAL;
+    }
+  }
+  if (!BindingTable_Add(bank, inputs,
+      SnesReportFormat_ButtonMask(format, button))) {
+    return -ENOSPC;
+  }
+  return 0;
+}
+
+int MappingText_Compile(const char* text, size_t length,
+    const struct SnesReportFormat* format, struct Profile* profile,
+    size_t* error_offset) {
+  const char* at = text;
+  const char* const end = text + length;
+  struct BindingTable* bank = profile->banks;
+  unsigned int i;
+  profile->num_inputs = 0;
+  profile->num_banks = 1;
+  BindingTable_Init(bank);
+  while (at != end) {
+    const char* token;
+    int result;
+    if (isspace(*at)) {
+      ++at;
+      continue;
+    }
+    if (*at == '#') {
+      while (at != end && *at != '\n') {
+        ++at;
+      }
+      continue;
+    }
+    token = at;
+    while (at != end && !isspace(*at)) {
+      ++at;
+    }
+    if (at - token == strlen(UGC_BANK_SEPARATOR) &&
+        memcmp(token, UGC_BANK_SEPARATOR, at - token) == 0) {
+      if (bank->num_rules == 0) {
+        // nothing bound since the last separator
+        continue;
+      }
+      if (profile->num_banks == UGC_MAX_BANKS) {
+        result = -ENOSPC;
+      } else {
+        bank = profile->banks + profile->num_banks++;
+        BindingTable_Init(bank);
+        continue;
+      }
+    } else {
+      result = MappingText_CompileBinding(token, at, format, profile, bank);
+    }
+    if (result != 0) {
+      *error_offset = token - text;
+      return result;
+    }
+  }
+  if (bank->num_rules == 0) {
+    // a trailing separator opens no bank
+    --profile->num_banks;
+  }
+  if (profile->num_banks == 0) {
+    *error_offset = length;
+    return -EINVAL;
+  }
+  for (i = 0; i < profile->num_banks; ++i) {
+    BindingTable_Compile(profile->banks + i);
+  }
+  return 0;
+}
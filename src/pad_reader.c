@@ -0,0 +1,162 @@
+#include <ugc/pad_reader.h>
+
+// Timings of a console poll: a 12us latch pulse, then 12us clock cycles.
+#define UGC_PAD_LATCH_NS 12000
+#define UGC_PAD_HALF_CLOCK_NS 6000
+
+// Step 0 raises the latch and step 1 drops it, leaving bit 0 on the line.
+// After that, even steps drop the clock and sample a bit, and odd steps
+// raise it so the pad shifts out the next one.
+#define UGC_PAD_FIRST_BIT_STEP 2u
+
+static void PadReader_Publish(struct PadReader *reader, u64 report) {
+  const struct SnesReportFormat *format = reader->format;
+  const u64 changed = report ^ (u64)atomic64_read(&reader->report);
+  unsigned int i;
+  if (likely(!changed)) {
+    return;
+  }
+  atomic64_set(&reader->report, report);
+  if (!reader->input) {
+    return;
+  }
+  for (i = 0; i < format->num_buttons; ++i) {
+    const u64 mask = SnesReportFormat_ButtonMask(format, i);
+    if (changed & mask) {
+      input_report_key(reader->input, format->button_code[i],
+          (report & mask) != 0);
+    }
+  }
+  input_sync(reader->input);
+}
+
+static enum hrtimer_restart PadReader_Step(struct hrtimer *timer) {
+  struct PadReader *reader = container_of(timer, struct PadReader, timer);
+  const unsigned int step = reader->step++;
+  s64 delay_ns = UGC_PAD_HALF_CLOCK_NS;
+
+  if (step == 0) {
+    reader->frame_start = hrtimer_get_expires(timer);
+    reader->shift = 0;
+    gpio_set_value(reader->latch.pin_number, kHigh);
+    delay_ns = UGC_PAD_LATCH_NS;
+  } else if (step == 1) {
+    gpio_set_value(reader->latch.pin_number, kLow);
+  } else {
+    const unsigned int bit = (step - UGC_PAD_FIRST_BIT_STEP) / 2;
+    if ((step & 1) == 0) {
+      gpio_set_value(reader->clock.pin_number, kLow);
+      // For SNES, pressed == low.
+      if (!gpio_get_value(reader->data.pin_number)) {
+        reader->shift |= BIT_ULL(bit);
+      }
+    } else {
+      gpio_set_value(reader->clock.pin_number, kHigh);
+      if (bit + 1 == reader->format->length) {
+        PadReader_Publish(reader, reader->shift & ~reader->format->id_bits);
+        atomic64_set(&reader->completed_ns, ktime_get_ns());
+        reader->step = 0;
+        if (!reader->period) {
+          return HRTIMER_NORESTART;
+        }
+        hrtimer_set_expires(timer,
+            ktime_add(reader->frame_start, reader->period));
+        return HRTIMER_RESTART;
+      }
+    }
+  }
+  hrtimer_forward_now(timer, ns_to_ktime(delay_ns));
+  return HRTIMER_RESTART;
+}
+
+static int PadReader_SetupInput(struct PadReader *reader,
+    const char *input_name) {
+  const struct SnesReportFormat *format = reader->format;
+  struct input_dev *input;
+  unsigned int i;
+  int result;
+
+  input = input_allocate_device();
+  if (!input) {
+    return -ENOMEM;
+  }
+  input->name = input_name;
+  input->phys = "ugc/pad0";
+  input->id.bustype = BUS_HOST;
+  __set_bit(EV_KEY, input->evbit);
+  for (i = 0; i < format->num_buttons; ++i) {
+    __set_bit(format->button_code[i], input->keybit);
+  }
+  result = input_register_device(input);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("%s input registration failed with code: %d\n"),
+        input_name, result);
+    input_free_device(input);
+    return result;
+  }
+  reader->input = input;
+  return 0;
+}
+
+int PadReader_Setup(struct PadReader *reader, const char *input_name) {
+  int result;
+  reader->input = NULL;
+  reader->step = 0;
+  atomic64_set(&reader->report, 0);
+  atomic64_set(&reader->completed_ns, 0);
+
+  result = PinConfig_Setup(&reader->latch);
+  if (result != 0) {
+    return result;
+  }
+  result = PinConfig_Setup(&reader->clock);
+  if (result != 0) {
+    goto err_release_latch;
+  }
+  result = PinConfig_Setup(&reader->data);
+  if (result != 0) {
+    goto err_release_clock;
+  }
+  if (input_name) {
+    result = PadReader_SetupInput(reader, input_name);
+    if (result != 0) {
+      goto err_release_data;
+    }
+  }
+  hrtimer_init(&reader->timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL_HARD);
+  reader->timer.function = PadReader_Step;
+  if (reader->period) {
+    hrtimer_start(&reader->timer, 0, HRTIMER_MODE_REL_HARD);
+  }
+  return 0;
+
+err_release_data:
+  PinConfig_Release(&reader->data);
+err_release_clock:
+  PinConfig_Release(&reader->clock);
+err_release_latch:
+  PinConfig_Release(&reader->latch);
+  return result;
+}
+
+void PadReader_Schedule(struct PadReader *reader, ktime_t start) {
+  if (!hrtimer_active(&reader->timer)) {
+    hrtimer_start(&reader->timer, start, HRTIMER_MODE_ABS_HARD);
+  }
+}
+
+ktime_t PadReader_ReadDuration(const struct PadReader *reader) {
+  return ns_to_ktime(UGC_PAD_LATCH_NS + UGC_PAD_HALF_CLOCK_NS +
+      2 * UGC_PAD_HALF_CLOCK_NS * reader->format->length);
+}
+
+void PadReader_Release(struct PadReader *reader) {
+  hrtimer_cancel(&reader->timer);
+  if (reader->input) {
+    input_unregister_device(reader->input);
+    reader->input = NULL;
+  }
+  PinConfig_Release(&reader->data);
+  PinConfig_Release(&reader->clock);
+  PinConfig_Release(&reader->latch);
+}
@@ -1,5 +1,133 @@
 #include <ugc/pin_config.h>
 
+#include <linux/irq.h>
+#include <linux/kernel.h>
+#include <linux/rcupdate.h>
+#include <linux/sched.h>
+#include <linux/sched/signal.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+
+int PinIrqPolicy_Parse(struct PinIrqPolicy *policy, const char *text) {
+  char *copy, *rest, *option;
+  int result = 0;
+  memset(policy, 0, sizeof(*policy));
+  copy = rest = kstrdup(text, GFP_KERNEL);
+  if (!copy) {
+    return -ENOMEM;
+  }
+  while (result == 0 && (option = strsep(&rest, ",")) != NULL) {
+    if (*option == '\0') {
+      continue;
+    } else if (strcmp(option, "nothread") == 0) {
+      policy->no_thread = true;
+    } else if (strcmp(option, "nobalancing") == 0) {
+      policy->no_balancing = true;
+    } else if (strncmp(option, "priority=", 9) == 0) {
+      result = kstrtoint(option + 9, 0, &policy->priority);
+      if (result == 0 && (policy->priority < 1 ||
+          policy->priority >= MAX_RT_PRIO)) {
+        result = -ERANGE;
+      }
+    } else if (strncmp(option, "cpus=", 5) == 0) {
+      // the rest of the text is the list
+      if (rest) {
+        rest[-1] = ',';
+      }
+      result = cpulist_parse(option + 5, &policy->cpus);
+      if (result == 0 && !cpumask_intersects(&policy->cpus,
+          cpu_online_mask)) {
+        result = -EINVAL;
+      }
+      rest = NULL;
+    } else {
+      result = -EINVAL;
+    }
+  }
+  kfree(copy);
+  return result;
+}
+
+// The thread a forced-threaded handler runs in, with a reference, or NULL
+// when it runs in hard IRQ context. The kernel names it irq/<number>-<label>.
+static struct task_struct *PinConfig_GetIrqThread(struct PinConfig *config) {
+  char name[TASK_COMM_LEN];
+  struct task_struct *task, *found = NULL;
+  snprintf(name, sizeof(name), "irq/%d-%s", config->input_irq_number,
+      config->label);
+  rcu_read_lock();
+  for_each_process(task) {
+    if ((task->flags & PF_KTHREAD) &&
+        strncmp(task->comm, name, sizeof(name)) == 0) {
+      found = get_task_struct(task);
+      break;
+    }
+  }
+  rcu_read_unlock();
+  return found;
+}
+
+static int PinConfig_ApplyIrqPolicy(struct PinConfig *config) {
+  const struct PinIrqPolicy *policy = &config->input_irq_policy;
+  const unsigned int irq = config->input_irq_number;
+  const struct cpumask *effective;
+  struct task_struct *thread;
+  int result = 0;
+  if (!cpumask_empty(&policy->cpus)) {
+    result = irq_set_affinity(irq, &policy->cpus);
+    if (result != 0) {
+      printk(KERN_DEBUG pr_fmt("%s IRQ %u affinity %*pbl failed with code: "
+          "%d\n"), config->label, irq, cpumask_pr_args(&policy->cpus),
+          result);
+      return result;
+    }
+  }
+  thread = PinConfig_GetIrqThread(config);
+  if (thread && policy->priority) {
+    const struct sched_param param = {
+      .sched_priority = policy->priority,
+    };
+    result = sched_setscheduler_nocheck(thread, SCHED_FIFO, &param);
+    if (result != 0) {
+      printk(KERN_DEBUG pr_fmt("%s IRQ %u thread priority %d failed with "
+          "code: %d\n"), config->label, irq, policy->priority, result);
+      goto out;
+    }
+  }
+  // read back what the kernel did rather than trusting the request; the
+  // thread follows the IRQ's affinity at its next run
+  effective = irq_data_get_effective_affinity_mask(irq_get_irq_data(irq));
+  if (thread) {
+    printk(KERN_DEBUG pr_fmt("%s IRQ %u: thread %s, FIFO %u, CPUs %*pbl%s\n"),
+        config->label, irq, thread->comm, thread->rt_priority,
+        cpumask_pr_args(effective),
+        policy->no_balancing ? ", not balanced" : "");
+  } else {
+    printk(KERN_DEBUG pr_fmt("%s IRQ %u: hard IRQ, CPUs %*pbl%s\n"),
+        config->label, irq, cpumask_pr_args(effective),
+        policy->no_balancing ? ", not balanced" : "");
+  }
+  if (!cpumask_empty(&policy->cpus) && !cpumask_empty(effective) &&
+      !cpumask_subset(effective, &policy->cpus)) {
+    printk(KERN_DEBUG pr_fmt("%s IRQ %u is outside CPUs %*pbl\n"),
+        config->label, irq, cpumask_pr_args(&policy->cpus));
+    result = -EIO;
+  } else if (policy->no_thread && thread) {
+    printk(KERN_DEBUG pr_fmt("%s IRQ %u was threaded anyway\n"),
+        config->label, irq);
+    result = -EIO;
+  } else if (policy->priority && !thread) {
+    // not an error: without forced threading there is nothing to raise
+    printk(KERN_DEBUG pr_fmt("%s IRQ %u isn't threaded; priority %d "
+        "unused\n"), config->label, irq, policy->priority);
+  }
+out:
+  if (thread) {
+    put_task_struct(thread);
+  }
+  return result;
+}
+
 bool PinConfig_HasInterrupt(struct PinConfig *config) {
   return ((config->input_irq_flags & IRQF_TRIGGER_MASK)
           && config->input_irq_handler);
@@ -37,7 +165,10 @@ int PinConfig_Setup(struct PinConfig *config) {
         result = request_irq(
             config->input_irq_number,
             config->input_irq_handler,
-            config->input_irq_flags,
+            config->input_irq_flags |
+                (config->input_irq_policy.no_thread ? IRQF_NO_THREAD : 0) |
+                (config->input_irq_policy.no_balancing ?
+                    IRQF_NOBALANCING : 0),
             config->label,
             NULL);
         if (result != 0) {
@@ -45,6 +176,11 @@ int PinConfig_Setup(struct PinConfig *config) {
               config->label, result);
           goto cleanup_gpio_request;
         }
+        result = PinConfig_ApplyIrqPolicy(config);
+        if (result != 0) {
+          free_irq(config->input_irq_number, NULL);
+          goto cleanup_gpio_request;
+        }
       }
       break;
     }
@@ -0,0 +1,382 @@
+#include <ugc/profile.h>
+
+#include <linux/debugfs.h>
+#include <linux/fs.h>
+#include <linux/mm.h>  // kvmalloc
+#include <linux/slab.h>
+#include <linux/string.h>
+
+#define UGC_PROFILE_MAGIC "UGCP"
+#define UGC_PROFILE_VERSION 1
+
+struct Profile* Profile_New(void) {
+  struct Profile* profile = kzalloc(sizeof(*profile), GFP_KERNEL);
+  if (profile) {
+    INIT_LIST_HEAD(&profile->node);
+    ControllerId_Init(&profile->id);
+  }
+  return profile;
+}
+
+void Profile_Delete(struct Profile* profile) {
+  if (profile) {
+    ControllerId_Clear(&profile->id);
+    kfree(profile);
+  }
+}
+
+void ProfileCache_Init(struct ProfileCache* cache) {
+  mutex_init(&cache->lock);
+  INIT_LIST_HEAD(&cache->profiles);
+}
+
+void ProfileCache_Clear(struct ProfileCache* cache) {
+  struct Profile *profile, *next;
+  mutex_lock(&cache->lock);
+  list_for_each_entry_safe(profile, next, &cache->profiles, node) {
+    list_del(&profile->node);
+    Profile_Delete(profile);
+  }
+  mutex_unlock(&cache->lock);
+}
+
+const struct Profile* ProfileCache_Find(struct ProfileCache* cache,
+    const struct ControllerId* id) {
+  struct Profile* profile;
+  lockdep_assert_held(&cache->lock);
+  list_for_each_entry(profile, &cache->profiles, node) {
+    if (ControllerId_Equal(&profile->id, id)) {
+      return profile;
+    }
+  }
+  return NULL;
+}
+
+// Call with cache->lock held.
+static void ProfileCache_StoreLocked(struct ProfileCache* cache,
+    struct Profile* profile) {
+  struct Profile* old = (struct Profile*)ProfileCache_Find(cache,
+      &profile->id);
+  if (old) {
+    list_replace(&old->node, &profile->node);
+    Profile_Delete(old);
+  } else {
+    list_add(&profile->node, &cache->profiles);
+  }
+}
+
+void ProfileCache_Store(struct ProfileCache* cache, struct Profile* profile) {
+  mutex_lock(&cache->lock);
+  ProfileCache_StoreLocked(cache, profile);
+  mutex_unlock(&cache->lock);
+}
+
+struct BlobCursor {
+  u8* data;  // NULL to only measure
+  size_t size;  // bytes consumed or produced so far
+  size_t capacity;  // bytes available to read
+};
+
+static const u8* BlobCursor_Take(struct BlobCursor* cursor, size_t size) {
+  const u8* data = cursor->data + cursor->size;
+  if (cursor->capacity - cursor->size < size) {
+    return NULL;
+  }
+  cursor->size += size;
+  return data;
+}
+
+static void BlobCursor_Put(struct BlobCursor* cursor, const void* data,
+    size_t size) {
+  if (cursor->data) {
+    memcpy(cursor->data + cursor->size, data, size);
+  }
+  cursor->size += size;
+}
+
+static void BlobCursor_PutU8(struct BlobCursor* cursor, u8 value) {
+  BlobCursor_Put(cursor, &value, sizeof(value));
+}
+
+static void BlobCursor_PutU16(struct BlobCursor* cursor, u16 value) {
+  const __le16 le = cpu_to_le16(value);
+  BlobCursor_Put(cursor, &le, sizeof(le));
+}
+
+static void BlobCursor_PutU64(struct BlobCursor* cursor, u64 value) {
+  const __le64 le = cpu_to_le64(value);
+  BlobCursor_Put(cursor, &le, sizeof(le));
+}
+
+static bool BlobCursor_TakeU8(struct BlobCursor* cursor, u8* value) {
+  const u8* data = BlobCursor_Take(cursor, sizeof(*value));
+  if (data) {
+    *value = *data;
+  }
+  return data != NULL;
+}
+
+// blob fields are unaligned, hence the copies
+static bool BlobCursor_TakeU16(struct BlobCursor* cursor, u16* value) {
+  const u8* data = BlobCursor_Take(cursor, sizeof(*value));
+  __le16 le;
+  if (data) {
+    memcpy(&le, data, sizeof(le));
+    *value = le16_to_cpu(le);
+  }
+  return data != NULL;
+}
+
+static bool BlobCursor_TakeU64(struct BlobCursor* cursor, u64* value) {
+  const u8* data = BlobCursor_Take(cursor, sizeof(*value));
+  __le64 le;
+  if (data) {
+    memcpy(&le, data, sizeof(le));
+    *value = le64_to_cpu(le);
+  }
+  return data != NULL;
+}
+
+static char* BlobCursor_TakeString(struct BlobCursor* cursor, u16 length) {
+  const u8* data = BlobCursor_Take(cursor, length);
+  char* string;
+  if (!data) {
+    return NULL;
+  }
+  string = kmalloc(length + 1, GFP_KERNEL);
+  if (string) {
+    memcpy(string, data, length);
+    string[length] = '\0';
+  }
+  return string;
+}
+
+static int Profile_Parse(struct Profile* profile, struct BlobCursor* cursor) {
+  u16 name_length, uniq_length, phys_length;
+  u8 num_inputs, num_banks;
+  unsigned int i, j;
+
+  if (!BlobCursor_TakeU16(cursor, &profile->id.bustype) ||
+      !BlobCursor_TakeU16(cursor, &name_length) ||
+      !BlobCursor_TakeU16(cursor, &uniq_length) ||
+      !BlobCursor_TakeU16(cursor, &phys_length)) {
+    return -EINVAL;
+  }
+  profile->id.name = BlobCursor_TakeString(cursor, name_length);
+  profile->id.uniq = BlobCursor_TakeString(cursor, uniq_length);
+  profile->id.phys = BlobCursor_TakeString(cursor, phys_length);
+  if (!profile->id.name || !profile->id.uniq || !profile->id.phys ||
+      !BlobCursor_TakeU8(cursor, &num_inputs) ||
+      !BlobCursor_TakeU8(cursor, &num_banks) ||
+      num_inputs > UGC_MAX_INPUTS || num_banks > UGC_MAX_BANKS ||
+      num_banks == 0) {
+    return -EINVAL;
+  }
+  profile->num_inputs = num_inputs;
+  for (i = 0; i < num_inputs; ++i) {
+    u16 type, code;
+    u8 positive, reserved;
+    if (!BlobCursor_TakeU16(cursor, &type) ||
+        !BlobCursor_TakeU16(cursor, &code) ||
+        !BlobCursor_TakeU8(cursor, &positive) ||
+        !BlobCursor_TakeU8(cursor, &reserved)) {
+      return -EINVAL;
+    }
+    profile->input[i] = (struct ProfileInput) {
+      .type = type,
+      .code = code,
+      .positive = (positive != 0),
+    };
+  }
+  profile->num_banks = num_banks;
+  for (i = 0; i < num_banks; ++i) {
+    struct BindingTable* table = profile->banks + i;
+    u8 num_rules;
+    if (!BlobCursor_TakeU8(cursor, &num_rules) || num_rules > UGC_MAX_RULES) {
+      return -EINVAL;
+    }
+    BindingTable_Init(table);
+    for (j = 0; j < num_rules; ++j) {
+      u64 inputs, output;
+      if (!BlobCursor_TakeU64(cursor, &inputs) ||
+          !BlobCursor_TakeU64(cursor, &output) ||
+          !inputs || num_inputs == 0 ||
+          (inputs & ~GENMASK_ULL(num_inputs - 1, 0))) {
+        return -EINVAL;
+      }
+      BindingTable_Add(table, inputs, output);
+    }
+    BindingTable_Compile(table);
+  }
+  return 0;
+}
+
+int ProfileCache_LoadBlob(struct ProfileCache* cache, const u8* data,
+    size_t size) {
+  struct BlobCursor cursor = {
+    .data = (u8*)data,
+    .capacity = size,
+  };
+  const u8* magic;
+  u16 version, count;
+  struct Profile *profile, *next;
+  LIST_HEAD(loaded);
+  unsigned int i;
+  int result = 0;
+
+  magic = BlobCursor_Take(&cursor, sizeof(UGC_PROFILE_MAGIC) - 1);
+  if (!magic || memcmp(magic, UGC_PROFILE_MAGIC,
+      sizeof(UGC_PROFILE_MAGIC) - 1) != 0 ||
+      !BlobCursor_TakeU16(&cursor, &version) ||
+      !BlobCursor_TakeU16(&cursor, &count)) {
+    return -EINVAL;
+  }
+  if (version != UGC_PROFILE_VERSION) {
+    printk(KERN_DEBUG pr_fmt("Unsupported profile version: %u\n"), version);
+    return -EINVAL;
+  }
+  // parse everything first so a truncated blob stores nothing
+  for (i = 0; i < count; ++i) {
+    profile = Profile_New();
+    if (!profile) {
+      result = -ENOMEM;
+      goto err_delete_loaded;
+    }
+    list_add_tail(&profile->node, &loaded);
+    result = Profile_Parse(profile, &cursor);
+    if (result != 0) {
+      goto err_delete_loaded;
+    }
+  }
+  mutex_lock(&cache->lock);
+  list_for_each_entry_safe(profile, next, &loaded, node) {
+    list_del_init(&profile->node);
+    ProfileCache_StoreLocked(cache, profile);
+  }
+  mutex_unlock(&cache->lock);
+  return count;
+
+err_delete_loaded:
+  list_for_each_entry_safe(profile, next, &loaded, node) {
+    list_del(&profile->node);
+    Profile_Delete(profile);
+  }
+  return result;
+}
+
+static void Profile_Serialize(const struct Profile* profile,
+    struct BlobCursor* cursor) {
+  const u16 name_length = strlen(profile->id.name);
+  const u16 uniq_length = strlen(profile->id.uniq);
+  const u16 phys_length = strlen(profile->id.phys);
+  unsigned int i, j;
+
+  BlobCursor_PutU16(cursor, profile->id.bustype);
+  BlobCursor_PutU16(cursor, name_length);
+  BlobCursor_PutU16(cursor, uniq_length);
+  BlobCursor_PutU16(cursor, phys_length);
+  BlobCursor_Put(cursor, profile->id.name, name_length);
+  BlobCursor_Put(cursor, profile->id.uniq, uniq_length);
+  BlobCursor_Put(cursor, profile->id.phys, phys_length);
+  BlobCursor_PutU8(cursor, profile->num_inputs);
+  BlobCursor_PutU8(cursor, profile->num_banks);
+  for (i = 0; i < profile->num_inputs; ++i) {
+    BlobCursor_PutU16(cursor, profile->input[i].type);
+    BlobCursor_PutU16(cursor, profile->input[i].code);
+    BlobCursor_PutU8(cursor, profile->input[i].positive);
+    BlobCursor_PutU8(cursor, 0);
+  }
+  for (i = 0; i < profile->num_banks; ++i) {
+    const struct BindingTable* table = profile->banks + i;
+    BlobCursor_PutU8(cursor, table->num_rules);
+    for (j = 0; j < table->num_rules; ++j) {
+      BlobCursor_PutU64(cursor, table->rule[j].inputs);
+      BlobCursor_PutU64(cursor, table->rule[j].output);
+    }
+  }
+}
+
+static void ProfileCache_Serialize(struct ProfileCache* cache,
+    struct BlobCursor* cursor) {
+  const struct Profile* profile;
+  u16 count = 0;
+  list_for_each_entry(profile, &cache->profiles, node) {
+    ++count;
+  }
+  BlobCursor_Put(cursor, UGC_PROFILE_MAGIC, sizeof(UGC_PROFILE_MAGIC) - 1);
+  BlobCursor_PutU16(cursor, UGC_PROFILE_VERSION);
+  BlobCursor_PutU16(cursor, count);
+  list_for_each_entry(profile, &cache->profiles, node) {
+    Profile_Serialize(profile, cursor);
+  }
+}
+
+int ProfileCache_SaveBlob(struct ProfileCache* cache, u8** data,
+    size_t* size) {
+  struct BlobCursor cursor = { 0 };
+  mutex_lock(&cache->lock);
+  // measure, then write
+  ProfileCache_Serialize(cache, &cursor);
+  cursor.data = kvmalloc(cursor.size, GFP_KERNEL);
+  if (!cursor.data) {
+    mutex_unlock(&cache->lock);
+    return -ENOMEM;
+  }
+  cursor.size = 0;
+  ProfileCache_Serialize(cache, &cursor);
+  mutex_unlock(&cache->lock);
+  *data = cursor.data;
+  *size = cursor.size;
+  return 0;
+}
+
+struct ProfileBlob {
+  u8* data;
+  size_t size;
+};
+
+static int ProfileBlob_Open(struct inode* inode, struct file* file) {
+  struct ProfileBlob* blob = kmalloc(sizeof(*blob), GFP_KERNEL);
+  int result;
+  if (!blob) {
+    return -ENOMEM;
+  }
+  // a snapshot, so reads in pieces stay consistent
+  result = ProfileCache_SaveBlob(inode->i_private, &blob->data, &blob->size);
+  if (result != 0) {
+    kfree(blob);
+    return result;
+  }
+  file->private_data = blob;
+  return 0;
+}
+
+static ssize_t ProfileBlob_Read(struct file* file, char __user* buffer,
+    size_t count, loff_t* offset) {
+  const struct ProfileBlob* blob = file->private_data;
+  return simple_read_from_buffer(buffer, count, offset, blob->data,
+      blob->size);
+}
+
+static int ProfileBlob_Release(struct inode* inode, struct file* file) {
+  struct ProfileBlob* blob = file->private_data;
+  kvfree(blob->data);
+  kfree(blob);
+  return 0;
+}
+
+static const struct file_operations kProfileBlobOperations = {
+  .owner = THIS_MODULE,
+  .open = ProfileBlob_Open,
+  .read = ProfileBlob_Read,
+  .release = ProfileBlob_Release,
+  .llseek = default_llseek,
+};
+
+void ProfileCache_CreateDebugfs(struct ProfileCache* cache,
+    struct dentry* parent) {
+  if (parent) {
+    debugfs_create_file("profiles.bin", 0400, parent, cache,
+        &kProfileBlobOperations);
+  }
+}
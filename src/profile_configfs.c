@@ -0,0 +1,206 @@
+#include <ugc/profile_configfs.h>
+
+#include <ugc/mapping_text.h>
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+
+#if IS_ENABLED(CONFIG_CONFIGFS_FS)
+
+// One directory under the subsystem.
+struct ProfileItem {
+  struct config_item item;
+  struct ProfileConfigfs *configfs;
+  struct mutex lock;  // guards id and mapping
+  struct ControllerId id;
+  char *mapping;  // text of the last mapping compiled, or NULL
+};
+
+static inline struct ProfileItem *to_profile_item(struct config_item *item) {
+  return container_of(item, struct ProfileItem, item);
+}
+
+// Attribute values are stored without the newline echo appends.
+static ssize_t ProfileItem_StoreString(struct ProfileItem *profile,
+    char **field, const char *page, size_t count) {
+  char *value = kstrndup(page, count, GFP_KERNEL);
+  if (!value) {
+    return -ENOMEM;
+  }
+  value[strcspn(value, "\n")] = '\0';
+  mutex_lock(&profile->lock);
+  kfree(*field);
+  *field = value;
+  mutex_unlock(&profile->lock);
+  return count;
+}
+
+#define UGC_PROFILE_ITEM_STRING(field) \
+static ssize_t ProfileItem_##field##_show(struct config_item *item, \
+    char *page) { \
+  struct ProfileItem *profile = to_profile_item(item); \
+  ssize_t size; \
+  mutex_lock(&profile->lock); \
+  size = scnprintf(page, PAGE_SIZE, "%s\n", profile->id.field); \
+  mutex_unlock(&profile->lock); \
+  return size; \
+} \
+static ssize_t ProfileItem_##field##_store(struct config_item *item, \
+    const char *page, size_t count) { \
+  struct ProfileItem *profile = to_profile_item(item); \
+  return ProfileItem_StoreString(profile, &profile->id.field, page, count); \
+} \
+CONFIGFS_ATTR(ProfileItem_, field)
+
+UGC_PROFILE_ITEM_STRING(name);
+UGC_PROFILE_ITEM_STRING(uniq);
+UGC_PROFILE_ITEM_STRING(phys);
+
+static ssize_t ProfileItem_bustype_show(struct config_item *item,
+    char *page) {
+  struct ProfileItem *profile = to_profile_item(item);
+  return scnprintf(page, PAGE_SIZE, "%#06x\n", READ_ONCE(profile->id.bustype));
+}
+
+static ssize_t ProfileItem_bustype_store(struct config_item *item,
+    const char *page, size_t count) {
+  struct ProfileItem *profile = to_profile_item(item);
+  u16 bustype;
+  int result = kstrtou16(page, 0, &bustype);
+  if (result != 0) {
+    return result;
+  }
+  mutex_lock(&profile->lock);
+  profile->id.bustype = bustype;
+  mutex_unlock(&profile->lock);
+  return count;
+}
+CONFIGFS_ATTR(ProfileItem_, bustype);
+
+static ssize_t ProfileItem_mapping_show(struct config_item *item,
+    char *page) {
+  struct ProfileItem *profile = to_profile_item(item);
+  ssize_t size;
+  mutex_lock(&profile->lock);
+  size = scnprintf(page, PAGE_SIZE, "%s", profile->mapping ?: "");
+  mutex_unlock(&profile->lock);
+  return size;
+}
+
+static ssize_t ProfileItem_mapping_store(struct config_item *item,
+    const char *page, size_t count) {
+  struct ProfileItem *item_profile = to_profile_item(item);
+  struct ProfileConfigfs *configfs = item_profile->configfs;
+  struct ControllerId id;
+  struct Profile *profile;
+  size_t error_offset;
+  char *text;
+  int result;
+  profile = Profile_New();
+  text = kstrndup(page, count, GFP_KERNEL);
+  if (!profile || !text) {
+    result = -ENOMEM;
+    goto err_free;
+  }
+  result = MappingText_Compile(page, count, configfs->format, profile,
+      &error_offset);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("Bad mapping at offset %zu: %d\n"),
+        error_offset, result);
+    goto err_free;
+  }
+  ControllerId_Init(&id);
+  mutex_lock(&item_profile->lock);
+  ControllerId_Set(&id, item_profile->id.name, item_profile->id.uniq,
+      item_profile->id.phys, item_profile->id.bustype);
+  kfree(item_profile->mapping);
+  item_profile->mapping = text;
+  mutex_unlock(&item_profile->lock);
+
+  ControllerId_Set(&profile->id, id.name, id.uniq, id.phys, id.bustype);
+  ProfileCache_Store(configfs->cache, profile);
+  configfs->applied(&id);
+  ControllerId_Clear(&id);
+  return count;
+
+err_free:
+  kfree(text);
+  Profile_Delete(profile);
+  return result;
+}
+CONFIGFS_ATTR(ProfileItem_, mapping);
+
+static struct configfs_attribute *g_profile_item_attrs[] = {
+  &ProfileItem_attr_name,
+  &ProfileItem_attr_uniq,
+  &ProfileItem_attr_phys,
+  &ProfileItem_attr_bustype,
+  &ProfileItem_attr_mapping,
+  NULL,
+};
+
+static void ProfileItem_Release(struct config_item *item) {
+  struct ProfileItem *profile = to_profile_item(item);
+  ControllerId_Clear(&profile->id);
+  kfree(profile->mapping);
+  kfree(profile);
+}
+
+static struct configfs_item_operations g_profile_item_ops = {
+  .release = ProfileItem_Release,
+};
+
+static const struct config_item_type g_profile_item_type = {
+  .ct_item_ops = &g_profile_item_ops,
+  .ct_attrs = g_profile_item_attrs,
+  .ct_owner = THIS_MODULE,
+};
+
+static struct config_item *ProfileConfigfs_MakeItem(
+    struct config_group *group, const char *name) {
+  struct ProfileItem *profile = kzalloc(sizeof(*profile), GFP_KERNEL);
+  if (!profile) {
+    return ERR_PTR(-ENOMEM);
+  }
+  profile->configfs = container_of(group, struct ProfileConfigfs,
+      subsystem.su_group);
+  mutex_init(&profile->lock);
+  // empty strings, as for a device without them
+  ControllerId_Set(&profile->id, NULL, NULL, NULL, 0);
+  config_item_init_type_name(&profile->item, name, &g_profile_item_type);
+  return &profile->item;
+}
+
+static struct configfs_group_operations g_profile_group_ops = {
+  .make_item = ProfileConfigfs_MakeItem,
+};
+
+static const struct config_item_type g_profile_group_type = {
+  .ct_group_ops = &g_profile_group_ops,
+  .ct_owner = THIS_MODULE,
+};
+
+int ProfileConfigfs_Setup(struct ProfileConfigfs *configfs) {
+  struct configfs_subsystem *subsystem = &configfs->subsystem;
+  int result;
+  config_group_init_type_name(&subsystem->su_group, KBUILD_MODNAME,
+      &g_profile_group_type);
+  mutex_init(&subsystem->su_mutex);
+  result = configfs_register_subsystem(subsystem);
+  if (result == 0) {
+    configfs->registered = true;
+  }
+  return result;
+}
+
+void ProfileConfigfs_Release(struct ProfileConfigfs *configfs) {
+  if (configfs->registered) {
+    configfs_unregister_subsystem(&configfs->subsystem);
+    configfs->registered = false;
+  }
+}
+
+#endif  // IS_ENABLED(CONFIG_CONFIGFS_FS)
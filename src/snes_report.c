@@ -0,0 +1,110 @@
+#include <ugc/snes_report.h>
+
+#include <linux/kernel.h>  // ARRAY_SIZE
+#include <linux/string.h>  // strcmp
+#include <linux/input.h>  // BTN_*, KEY_*
+
+// B, Y, Select, Start, Up, Down, Left, Right, A, X, L, R
+#define UGC_JOYPAD_BUTTON_BITS 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
+
+#define UGC_JOYPAD_BUTTON_NAMES \
+  "B", "Y", "Select", "Start", "Up", "Down", "Left", "Right", "A", "X", "L", "R"
+
+#define UGC_JOYPAD_BUTTON_CODES \
+  BTN_SOUTH, BTN_WEST, BTN_SELECT, BTN_START, \
+  BTN_DPAD_UP, BTN_DPAD_DOWN, BTN_DPAD_LEFT, BTN_DPAD_RIGHT, \
+  BTN_EAST, BTN_NORTH, BTN_TL, BTN_TR
+
+// A, B, Select, Start, Up, Down, Left, Right
+static const unsigned char kNesButtonBits[] = {
+  0, 1, 2, 3, 4, 5, 6, 7
+};
+static const unsigned int kNesButtonCodes[] = {
+  BTN_EAST, BTN_SOUTH, BTN_SELECT, BTN_START,
+  BTN_DPAD_UP, BTN_DPAD_DOWN, BTN_DPAD_LEFT, BTN_DPAD_RIGHT
+};
+static const char* const kNesButtonNames[] = {
+  "A", "B", "Select", "Start", "Up", "Down", "Left", "Right"
+};
+
+static const unsigned char kStandardButtonBits[] = {
+  UGC_JOYPAD_BUTTON_BITS
+};
+static const unsigned int kStandardButtonCodes[] = {
+  UGC_JOYPAD_BUTTON_CODES
+};
+static const char* const kStandardButtonNames[] = {
+  UGC_JOYPAD_BUTTON_NAMES
+};
+
+// Joypad buttons, then 0-9, *, #, ., C and End Communication. Bit 30 is
+// unused and bits 12-15 carry the id.
+static const unsigned char kNttKeypadButtonBits[] = {
+  UGC_JOYPAD_BUTTON_BITS,
+  16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 31
+};
+static const unsigned int kNttKeypadButtonCodes[] = {
+  UGC_JOYPAD_BUTTON_CODES,
+  KEY_NUMERIC_0, KEY_NUMERIC_1, KEY_NUMERIC_2, KEY_NUMERIC_3, KEY_NUMERIC_4,
+  KEY_NUMERIC_5, KEY_NUMERIC_6, KEY_NUMERIC_7, KEY_NUMERIC_8, KEY_NUMERIC_9,
+  KEY_NUMERIC_STAR, KEY_NUMERIC_POUND, KEY_KPDOT, KEY_CLEAR, KEY_HANGUP_PHONE
+};
+static const char* const kNttKeypadButtonNames[] = {
+  UGC_JOYPAD_BUTTON_NAMES,
+  "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "*", "#", ".", "C", "End"
+};
+
+static const struct SnesReportFormat kSnesReportFormats[] = {
+  {
+    .name = "nes",
+    .length = 8,
+    .num_buttons = ARRAY_SIZE(kNesButtonBits),
+    .button_bit = kNesButtonBits,
+    .button_code = kNesButtonCodes,
+    .button_name = kNesButtonNames,
+    .id_bits = 0,
+    .line_mask = GENMASK_ULL(7, 0),
+  },
+  {
+    .name = "standard",
+    .length = 16,
+    .num_buttons = ARRAY_SIZE(kStandardButtonBits),
+    .button_bit = kStandardButtonBits,
+    .button_code = kStandardButtonCodes,
+    .button_name = kStandardButtonNames,
+    .id_bits = 0,  // 0000
+    .line_mask = GENMASK_ULL(15, 0),
+  },
+  {
+    .name = "ntt_keypad",
+    .length = 32,
+    .num_buttons = ARRAY_SIZE(kNttKeypadButtonBits),
+    .button_bit = kNttKeypadButtonBits,
+    .button_code = kNttKeypadButtonCodes,
+    .button_name = kNttKeypadButtonNames,
+    .id_bits = BIT_ULL(13),  // 0100
+    .line_mask = GENMASK_ULL(31, 0),
+  },
+};
+
+const struct SnesReportFormat* SnesReportFormat_Find(const char* name) {
+  unsigned int i;
+  for (i = 0; i < ARRAY_SIZE(kSnesReportFormats); ++i) {
+    if (strcmp(kSnesReportFormats[i].name, name) == 0) {
+      return kSnesReportFormats + i;
+    }
+  }
+  return NULL;
+}
+
+int SnesReportFormat_FindButton(const struct SnesReportFormat* format,
+    const char* name, size_t length) {
+  unsigned int i;
+  for (i = 0; i < format->num_buttons; ++i) {
+    if (strncmp(format->button_name[i], name, length) == 0 &&
+        format->button_name[i][length] == '\0') {
+      return i;
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,114 @@
+#include <ugc/state_page.h>
+
+#include <linux/fs.h>
+#include <linux/gfp.h>
+#include <linux/mm.h>
+#include <linux/poll.h>
+#include <linux/slab.h>
+
+// One per open file.
+struct StatePageReader {
+  struct StatePage *state;
+  u64 frame;  // last frame poll reported
+};
+
+static void StatePage_Wake(struct irq_work *work) {
+  struct StatePage *state = container_of(work, struct StatePage, wake);
+  wake_up_interruptible(&state->wait);
+}
+
+static int StatePage_Open(struct inode *inode, struct file *file) {
+  struct StatePageReader *reader = kmalloc(sizeof(*reader), GFP_KERNEL);
+  if (!reader) {
+    return -ENOMEM;
+  }
+  // misc_open points private_data at the miscdevice
+  reader->state = container_of(file->private_data, struct StatePage, misc);
+  reader->frame = READ_ONCE(reader->state->page->frame);
+  file->private_data = reader;
+  return 0;
+}
+
+static int StatePage_Close(struct inode *inode, struct file *file) {
+  kfree(file->private_data);
+  return 0;
+}
+
+static __poll_t StatePage_Poll(struct file *file, poll_table *wait) {
+  struct StatePageReader *reader = file->private_data;
+  u64 frame;
+  poll_wait(file, &reader->state->wait, wait);
+  frame = READ_ONCE(reader->state->page->frame);
+  if (frame == reader->frame) {
+    return 0;
+  }
+  // frames are coalesced; the page only has the newest
+  reader->frame = frame;
+  return EPOLLIN | EPOLLRDNORM;
+}
+
+static int StatePage_Mmap(struct file *file, struct vm_area_struct *vma) {
+  struct StatePageReader *reader = file->private_data;
+  if (vma->vm_pgoff != 0 || vma->vm_end - vma->vm_start != PAGE_SIZE) {
+    return -EINVAL;
+  }
+  if (vma->vm_flags & VM_WRITE) {
+    return -EPERM;
+  }
+  vm_flags_clear(vma, VM_MAYWRITE);
+  return vm_insert_page(vma, vma->vm_start,
+      virt_to_page(reader->state->page));
+}
+
+static const struct file_operations kStatePageFops = {
+  .owner = THIS_MODULE,
+  .open = StatePage_Open,
+  .release = StatePage_Close,
+  .poll = StatePage_Poll,
+  .mmap = StatePage_Mmap,
+  .llseek = noop_llseek,
+};
+
+int StatePage_Setup(struct StatePage *state,
+    const struct SnesReportFormat *format) {
+  unsigned int i;
+  int result;
+  BUILD_BUG_ON(sizeof(struct UgcStatePage) > PAGE_SIZE);
+  state->page = (struct UgcStatePage *)get_zeroed_page(GFP_KERNEL);
+  if (!state->page) {
+    return -ENOMEM;
+  }
+  state->page->active_device = -1;
+  state->page->num_buttons = format->num_buttons;
+  for (i = 0; i < format->num_buttons; ++i) {
+    state->page->button_bit[i] = format->button_bit[i];
+  }
+  init_waitqueue_head(&state->wait);
+  init_irq_work(&state->wake, StatePage_Wake);
+  state->misc = (struct miscdevice) {
+    .minor = MISC_DYNAMIC_MINOR,
+    .name = "ugc_state",
+    .fops = &kStatePageFops,
+    .mode = 0444,
+  };
+  result = misc_register(&state->misc);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("State page registration failed with code: "
+        "%d\n"), result);
+    free_page((unsigned long)state->page);
+    state->page = NULL;
+    return result;
+  }
+  return 0;
+}
+
+void StatePage_Release(struct StatePage *state) {
+  if (!state->page) {
+    return;
+  }
+  misc_deregister(&state->misc);
+  irq_work_sync(&state->wake);
+  // a mapping still open holds its own reference to the page
+  free_page((unsigned long)state->page);
+  state->page = NULL;
+}
@@ -0,0 +1,121 @@
+#include <ugc/stats.h>
+
+#include <ugc/binding_table.h>
+
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/math64.h>
+#include <linux/random.h>
+#include <linux/slab.h>
+#include <linux/ktime.h>
+
+#define UGC_BENCH_ITERATIONS 100000u
+
+struct Stats g_stats = {
+  .pad_age_ns_min = S64_MAX,
+};
+
+static struct dentry *g_stats_dir = NULL;
+
+static int Stats_show(struct seq_file *file, void *unused) {
+  const struct Stats *stats = &g_stats;
+  unsigned int i;
+  seq_printf(file, "latches: %llu\n", stats->latches);
+  seq_printf(file, "taps: %llu sub_frame %llu lost %llu\n", stats->taps,
+      stats->taps_sub_frame, stats->taps_lost);
+  if (stats->failovers) {
+    seq_printf(file, "failovers: %llu\n", stats->failovers);
+    seq_printf(file, "failover_ns: last %lld max %lld\n",
+        stats->failover_ns_last, stats->failover_ns_max);
+  }
+  if (stats->tas_frames || stats->tas_underruns) {
+    seq_printf(file, "tas: frames %llu underruns %llu\n", stats->tas_frames,
+        stats->tas_underruns);
+  }
+  for (i = 0; i < UGC_EDGE_BUCKETS; ++i) {
+    if (stats->edge_ns[i]) {
+      break;
+    }
+  }
+  if (i < UGC_EDGE_BUCKETS) {
+    seq_puts(file, "edge_ns:");
+    for (i = 0; i < UGC_EDGE_BUCKETS - 1; ++i) {
+      seq_printf(file, " <%u %llu", 64u << i, stats->edge_ns[i]);
+    }
+    seq_printf(file, " more %llu\n", stats->edge_ns[i]);
+  }
+  if (stats->pad_reports) {
+    seq_printf(file, "pad_reports: %llu\n", stats->pad_reports);
+    seq_printf(file, "pad_reports_stale: %llu\n", stats->pad_reports_stale);
+    seq_printf(file, "latch_period_ns: %lld\n", stats->latch_period_ns);
+  }
+  if (stats->pad_reports > stats->pad_reports_unread) {
+    seq_printf(file, "pad_age_ns: last %lld min %lld max %lld avg %lld\n",
+        stats->pad_age_ns_last, stats->pad_age_ns_min, stats->pad_age_ns_max,
+        div64_s64(stats->pad_age_ns_total,
+            stats->pad_reports - stats->pad_reports_unread));
+  }
+  return 0;
+}
+// defines Stats_fops around Stats_show
+DEFINE_SHOW_ATTRIBUTE(Stats);
+
+// Times BindingTable_Evaluate as the rule count grows. Rules are a mix of
+// single inputs and two-input chords, with random held inputs.
+static int BindingBench_show(struct seq_file *file, void *unused) {
+  static const unsigned int kSizes[] = { 1, 4, 8, 16, UGC_MAX_RULES };
+  struct BindingTable *table;
+  u64 raw[16];
+  unsigned int i, j;
+
+  table = kmalloc(sizeof(*table), GFP_KERNEL);
+  if (!table) {
+    return -ENOMEM;
+  }
+  for (i = 0; i < ARRAY_SIZE(raw); ++i) {
+    raw[i] = get_random_u64();
+  }
+  for (i = 0; i < ARRAY_SIZE(kSizes); ++i) {
+    u64 sink = 0;
+    u64 start_ns, elapsed_ns;
+    BindingTable_Init(table);
+    for (j = 0; j < kSizes[i]; ++j) {
+      const u64 inputs = BIT_ULL(j) | ((j & 1) ? BIT_ULL((j * 7) & 63) : 0);
+      BindingTable_Add(table, inputs, BIT_ULL(j % 12));
+    }
+    BindingTable_Compile(table);
+    start_ns = ktime_get_ns();
+    for (j = 0; j < UGC_BENCH_ITERATIONS; ++j) {
+      sink ^= BindingTable_Evaluate(table, raw[j % ARRAY_SIZE(raw)]);
+    }
+    elapsed_ns = ktime_get_ns() - start_ns;
+    seq_printf(file, "rules %2u: %llu ps/evaluation (%llx)\n",
+        table->num_rules,
+        div_u64(elapsed_ns * 1000, UGC_BENCH_ITERATIONS), sink);
+  }
+  kfree(table);
+  return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(BindingBench);
+
+int Stats_Setup(void) {
+  g_stats_dir = debugfs_create_dir(KBUILD_MODNAME, NULL);
+  if (IS_ERR(g_stats_dir)) {
+    // debugfs is optional; the module works without it
+    g_stats_dir = NULL;
+    return 0;
+  }
+  debugfs_create_file("stats", 0444, g_stats_dir, NULL, &Stats_fops);
+  debugfs_create_file("binding_bench", 0400, g_stats_dir, NULL,
+      &BindingBench_fops);
+  return 0;
+}
+
+struct dentry* Stats_Directory(void) {
+  return g_stats_dir;
+}
+
+void Stats_Release(void) {
+  debugfs_remove_recursive(g_stats_dir);
+  g_stats_dir = NULL;
+}
@@ -0,0 +1,58 @@
+#include <ugc/tap_capture.h>
+
+#include <ugc/stats.h>
+
+#include <linux/bitops.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+
+void TapCapture_Init(struct TapCapture *capture,
+    const struct SnesReportFormat *format, const unsigned int *frames,
+    unsigned int count) {
+  unsigned int i;
+  memset(capture, 0, sizeof(*capture));
+  for (i = 0; i < format->num_buttons; ++i) {
+    const unsigned int bit = format->button_bit[i];
+    unsigned int policy = 1;
+    if (count == 1) {
+      policy = frames[0];
+    } else if (i < count) {
+      policy = frames[i];
+    }
+    capture->frames[bit] = min(policy, (unsigned int)U8_MAX);
+    if (policy >= 1) {
+      capture->enabled |= BIT_ULL(bit);
+    }
+    if (policy >= 2) {
+      capture->extended |= BIT_ULL(bit);
+    }
+  }
+}
+
+u64 TapCapture_Latch(struct TapCapture *capture, u64 pressed, u64 taps) {
+  const u64 released = taps & ~pressed;
+  u64 report = pressed | (taps & capture->enabled) | capture->holding;
+  u64 owed = capture->holding;
+  while (owed) {
+    // this frame pays one of an earlier hold
+    const unsigned int bit = __ffs64(owed);
+    owed &= owed - 1;
+    if (--capture->remaining[bit] == 0) {
+      capture->holding &= ~BIT_ULL(bit);
+    }
+  }
+  owed = taps & capture->extended;
+  while (owed) {
+    // a new tap restarts its hold, counting this frame
+    const unsigned int bit = __ffs64(owed);
+    owed &= owed - 1;
+    capture->remaining[bit] = capture->frames[bit] - 1;
+    capture->holding |= BIT_ULL(bit);
+  }
+  if (taps) {
+    g_stats.taps += hweight64(taps);
+    g_stats.taps_sub_frame += hweight64(released);
+    g_stats.taps_lost += hweight64(released & ~capture->enabled);
+  }
+  return report;
+}
@@ -0,0 +1,210 @@
+#include <ugc/tas.h>
+
+#include <ugc/stats.h>
+
+#include <linux/fs.h>
+#include <linux/log2.h>
+#include <linux/mm.h>
+#include <linux/overflow.h>
+#include <linux/poll.h>
+#include <linux/rcupdate.h>
+#include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+
+#define CREATE_TRACE_POINTS
+#include <ugc/tas_trace.h>
+
+// bits of Tas::open
+#define UGC_TAS_PLAYING 0
+#define UGC_TAS_CLAIMED 1
+
+static struct Tas *Tas_FromFile(struct file *file) {
+  // misc_open points private_data at the miscdevice
+  return container_of(file->private_data, struct Tas, misc);
+}
+
+// Words queued and not yet played.
+static inline u32 Tas_Fill(const struct Tas *tas) {
+  return READ_ONCE(tas->ring->head) - READ_ONCE(tas->tail);
+}
+
+static void Tas_Wake(struct irq_work *work) {
+  struct Tas *tas = container_of(work, struct Tas, wake);
+  wake_up_interruptible(&tas->wait);
+}
+
+static int Tas_Open(struct inode *inode, struct file *file) {
+  struct Tas *tas = Tas_FromFile(file);
+  if (test_and_set_bit(UGC_TAS_CLAIMED, &tas->open)) {
+    return -EBUSY;
+  }
+  // the latch isn't playing yet, so the ring is ours to reset
+  tas->tail = 0;
+  tas->started = false;
+  tas->ring->head = 0;
+  tas->ring->tail = 0;
+  tas->ring->low_watermark = (tas->mask + 1) / 4;
+  tas->ring->underruns = 0;
+  smp_mb__before_atomic();
+  set_bit(UGC_TAS_PLAYING, &tas->open);
+  return 0;
+}
+
+static int Tas_Close(struct inode *inode, struct file *file) {
+  struct Tas *tas = Tas_FromFile(file);
+  clear_bit(UGC_TAS_PLAYING, &tas->open);
+  // A latch already inside still advances the ring; both engines latch
+  // with interrupts off, so once a grace period passes none is, and the
+  // next open may reset it.
+  synchronize_rcu();
+  clear_bit_unlock(UGC_TAS_CLAIMED, &tas->open);
+  return 0;
+}
+
+static ssize_t Tas_Write(struct file *file, const char __user *buffer,
+    size_t count, loff_t *offset) {
+  struct Tas *tas = Tas_FromFile(file);
+  const u32 size = tas->mask + 1;
+  size_t written = 0;
+  ssize_t result = 0;
+  if (count % sizeof(u64) != 0) {
+    return -EINVAL;
+  }
+  if (mutex_lock_interruptible(&tas->write_lock)) {
+    return -ERESTARTSYS;
+  }
+  while (written < count) {
+    const u32 head = tas->ring->head;
+    u32 words = size - Tas_Fill(tas);
+    if (words == 0) {
+      if (written || (file->f_flags & O_NONBLOCK)) {
+        result = written ? 0 : -EAGAIN;
+        break;
+      }
+      result = wait_event_interruptible(tas->wait, Tas_Fill(tas) < size);
+      if (result != 0) {
+        break;
+      }
+      continue;
+    }
+    // up to the end of the ring; the rest goes round on the next pass
+    words = min3(words, size - (head & tas->mask),
+        (u32)((count - written) / sizeof(u64)));
+    if (copy_from_user(tas->frames + (head & tas->mask), buffer + written,
+        words * sizeof(u64))) {
+      result = -EFAULT;
+      break;
+    }
+    smp_store_release(&tas->ring->head, head + words);
+    written += words * sizeof(u64);
+  }
+  mutex_unlock(&tas->write_lock);
+  return written ? written : result;
+}
+
+static __poll_t Tas_Poll(struct file *file, poll_table *wait) {
+  struct Tas *tas = Tas_FromFile(file);
+  poll_wait(file, &tas->wait, wait);
+  if (Tas_Fill(tas) <= READ_ONCE(tas->ring->low_watermark)) {
+    return EPOLLOUT | EPOLLWRNORM;
+  }
+  return 0;
+}
+
+static int Tas_Mmap(struct file *file, struct vm_area_struct *vma) {
+  // a private mapping's writes would go to a copy the latch never reads
+  if (!(vma->vm_flags & VM_SHARED)) {
+    return -EINVAL;
+  }
+  return remap_vmalloc_range(vma, Tas_FromFile(file)->ring, vma->vm_pgoff);
+}
+
+static const struct file_operations kTasFops = {
+  .owner = THIS_MODULE,
+  .open = Tas_Open,
+  .release = Tas_Close,
+  .write = Tas_Write,
+  .poll = Tas_Poll,
+  .mmap = Tas_Mmap,
+  .llseek = noop_llseek,
+};
+
+int Tas_Setup(struct Tas *tas, unsigned int size) {
+  int result;
+  if (size == 0) {
+    return 0;
+  }
+  if (size > UGC_TAS_MAX_FRAMES) {
+    return -EINVAL;
+  }
+  size = roundup_pow_of_two(size);
+  tas->ring = vmalloc_user(size_add(UGC_TAS_RING_OFFSET,
+      array_size(size, sizeof(u64))));
+  if (!tas->ring) {
+    return -ENOMEM;
+  }
+  tas->ring->size = size;
+  tas->frames = (u64 *)((char *)tas->ring + UGC_TAS_RING_OFFSET);
+  tas->mask = size - 1;
+  tas->open = 0;
+  mutex_init(&tas->write_lock);
+  init_waitqueue_head(&tas->wait);
+  init_irq_work(&tas->wake, Tas_Wake);
+  tas->misc = (struct miscdevice) {
+    .minor = MISC_DYNAMIC_MINOR,
+    .name = "ugc_tas",
+    .fops = &kTasFops,
+    .mode = 0600,
+  };
+  result = misc_register(&tas->misc);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("TAS registration failed with code: %d\n"),
+        result);
+    vfree(tas->ring);
+    tas->ring = NULL;
+    return result;
+  }
+  return 0;
+}
+
+void Tas_Release(struct Tas *tas) {
+  if (!tas->ring) {
+    return;
+  }
+  misc_deregister(&tas->misc);
+  irq_work_sync(&tas->wake);
+  vfree(tas->ring);
+  tas->ring = NULL;
+}
+
+u64 Tas_Latch(struct Tas *tas, u64 pressed) {
+  struct UgcTasRing *ring = tas->ring;
+  const u32 head = smp_load_acquire(&ring->head);
+  const u32 tail = tas->tail;
+  u32 fill = head - tail;
+  u64 report;
+  if (fill == 0 || fill > tas->mask + 1) {
+    // empty, or a head the player scribbled over
+    if (!tas->started) {
+      return pressed;
+    }
+    report = 0;
+    ++g_stats.tas_underruns;
+    WRITE_ONCE(ring->underruns, ring->underruns + 1);
+    trace_ugc_tas_underrun(tail);
+    fill = 0;
+  } else {
+    tas->started = true;
+    report = READ_ONCE(tas->frames[tail & tas->mask]);
+    trace_ugc_tas_frame(tail, report);
+    tas->tail = tail + 1;
+    smp_store_release(&ring->tail, tail + 1);
+    ++g_stats.tas_frames;
+    --fill;
+  }
+  if (fill <= READ_ONCE(ring->low_watermark) &&
+      wq_has_sleeper(&tas->wait)) {
+    irq_work_queue(&tas->wake);
+  }
+  return report;
+}
@@ -0,0 +1,44 @@
+#include <ugc/turbo.h>
+
+#include <linux/bitops.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+
+void Turbo_Init(struct Turbo *turbo, const struct SnesReportFormat *format,
+    const unsigned int *frames, unsigned int count) {
+  unsigned int i;
+  memset(turbo, 0, sizeof(*turbo));
+  for (i = 0; i < count && i < format->num_buttons; ++i) {
+    const unsigned int bit = format->button_bit[i];
+    if (frames[i]) {
+      turbo->frames[bit] = min(frames[i], (unsigned int)U8_MAX);
+      turbo->buttons |= BIT_ULL(bit);
+    }
+  }
+}
+
+u64 Turbo_Latch(struct Turbo *turbo, u64 pressed) {
+  const u64 held = pressed & turbo->buttons;
+  // a new press starts pressed
+  u64 bits = held & ~turbo->held;
+  u64 report;
+  turbo->off &= held;
+  while (bits) {
+    const unsigned int bit = __ffs64(bits);
+    bits &= bits - 1;
+    turbo->remaining[bit] = turbo->frames[bit];
+  }
+  turbo->held = held;
+  report = pressed ^ turbo->off;
+  // this latch ends a phase for some
+  bits = held;
+  while (bits) {
+    const unsigned int bit = __ffs64(bits);
+    bits &= bits - 1;
+    if (--turbo->remaining[bit] == 0) {
+      turbo->remaining[bit] = turbo->frames[bit];
+      turbo->off ^= BIT_ULL(bit);
+    }
+  }
+  return report;
+}
@@ -6,13 +6,42 @@
 #include <linux/init.h>
 #include <linux/device.h>
 
+#include <ugc/axis.h>
+#include <ugc/binding_table.h>
+#include <ugc/controller.h>
+#include <ugc/controller_db.h>
 #include <ugc/controller_id.h>
+#include <ugc/dpad.h>
+#include <ugc/gamepad_output.h>
 #include <ugc/info_strings.h>
+#include <ugc/inject.h>
 #include <ugc/input_state.h>
+#include <ugc/interposer.h>
+#include <ugc/mapping_bpf.h>
+#include <ugc/pad_reader.h>
 #include <ugc/pin_config.h>
+#include <ugc/profile.h>
+#include <ugc/profile_configfs.h>
+#include <ugc/snes_report.h>
+#include <ugc/state_page.h>
+#include <ugc/stats.h>
+#include <ugc/tap_capture.h>
+#include <ugc/tas.h>
+#include <ugc/turbo.h>
 
 #include <linux/interrupt.h>
 #include <linux/gpio.h>
+#include <linux/atomic.h>
+#include <linux/firmware.h>
+#include <linux/mutex.h>
+#include <linux/idr.h>
+#include <linux/list.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
+#include <linux/cpumask.h>
+#include <linux/kthread.h>
+#include <linux/sched.h>
+#include <linux/sched/isolation.h>
 
 // https://www.kernel.org/doc/Documentation/input/event-codes.txt
 // https://github.com/torvalds/linux/blob/master/include/uapi/linux/input-event-codes.h
@@ -26,10 +55,10 @@ MODULE_LICENSE("GPL");
 
 #define HANDLER_NAME "universal_game_controller"
 
-#define UGC_MAX_DEVICES 256u
 #define UGC_CONFIGURE_REPEAT_COUNT 10u
-#define UGC_MAX_INPUTS 50
-#define UGC_NAME_TO_INDEX(name) (+(unsigned char)*(name))
+#define UGC_NO_BANK -1
+// input storage starts this small and doubles up to UGC_MAX_INPUTS
+#define UGC_MIN_INPUT_CAPACITY 8u
 
 const __u32 kPressedThreshold = U32_MAX / 2;
 
@@ -38,74 +67,280 @@ enum ConfigState {
 };
 
 // start with final button to configure; store that as terminal
+//
+// While configuring, the inputs held for a button are bound together once
+// all of them are released: one input binds normally, several bind a
+// chord, and an input that is already bound fans out to this button too.
+//
+// Once ready, the bank hotkey steps through the device's binding banks,
+// and stepping past the last one configures a new bank. That runs while
+// the current bank stays active, and the hotkey ends it.
+//
+// Devices come from g_device_cache and hang off handle->private. Input and
+// bank storage is allocated as bindings need it and kept across resets.
 struct Device {
+  struct list_head node;  // in g_devices, under g_device_mutex
+  struct list_head ready_node;  // in g_ready_devices while ready
+  int index;  // from g_device_ida; names the device in logs
   struct input_dev *dev;  // name, uniq, phys, id.bustype
+  struct ControllerId id;  // profile key; populated while connected
+  unsigned int input_capacity;
+  struct InputState *input_nodes;  // storage for nodes of the tree
+  __u32 *input_state;
+  struct BindingTable *banks[UGC_MAX_BANKS];  // NULL until first used
+  // EV_ABS axes the device has, below the multitouch codes
+  unsigned int num_axes;
+  struct Axis *axes;
+  s8 axis_index[ABS_MT_SLOT];  // into axes, or -1
+  // events were ignored (while idle); the state is read back from the
+  // input core at the next SYN_REPORT
+  bool stale;
+
+  // everything from here on is cleared by Device_ResetConfig
   enum ConfigState config_state;
-  unsigned int count;  // repeat count in kConfiguring state, button count in kReady state
+  unsigned int count;  // repeat count in kConnected state, button count while configuring
   struct InputState last_input;
-  struct InputState input_nodes[UGC_MAX_INPUTS];  // storage for nodes of the tree
+  // each distinct bound input, at the index of its raw bit
+  unsigned int num_inputs;
   struct rb_root input_code_to_index;  // = RB_ROOT; but that just zeroes...
-  __u32 input_state[UGC_MAX_INPUTS];
+  u64 raw;  // held inputs, by raw bit
+  u64 motion;  // raw bits pressed by EV_REL this frame, released after it
+  u64 published_raw;  // raw as of the last Device_Commit
+  u8 stick_direction;  // UGC_DPAD_* bits of the stick, with stick_dpad
+  u8 published_stick_direction;
+  u64 pending;  // kConfiguring: inputs held for the button being bound
+  unsigned int num_banks;  // configured banks
+  unsigned int active_bank;
+  int editing_bank;  // bank being configured, or UGC_NO_BANK
+  const struct BindingTable *table;  // banks[active_bank] once ready
+  atomic64_t report;  // packed report word; read by the latch interrupt
+  atomic64_t taps;  // report bits pressed since the last latch took them
+  u64 bound;  // report bits with a binding
 };
 
-// dev of null reuses the existing value
-void Device_ResetConfig(struct Device *device, struct input_dev *dev) {
-  if (likely(!dev)) {
-    dev = device->dev;
-  }
-  *device = (struct Device) {
-    .dev = dev,
-    .input_code_to_index = RB_ROOT
-  };
+void Device_ResetConfig(struct Device *device) {
+  memset(&device->config_state, 0,
+      sizeof(*device) - offsetof(struct Device, config_state));
+  device->input_code_to_index = RB_ROOT;
 }
 
-struct DeviceGroup {
-  unsigned long acquiredbit[BITS_TO_LONGS(UGC_MAX_DEVICES)];
-  unsigned int num_acquired;
-};
-
-static struct DeviceGroup g_device_group = {0};
-static struct Device g_devices[UGC_MAX_DEVICES];
-// TODO: support multiple later?
+static struct kmem_cache *g_device_cache = NULL;
+static DEFINE_IDA(g_device_ida);
+// every connected device
+static LIST_HEAD(g_devices);
+// Ready devices, least recently activated first. Under kMergeReplace only
+// the last is a controller member and the rest stand by for failover.
+static LIST_HEAD(g_ready_devices);
+// last of g_ready_devices
 static struct Device *g_active_device = NULL;
+// its index, for the latch to publish without touching the device
+static int g_active_index = -1;
+// guards both, which change from event context, and orders the controller
+// updates made with them
+static DEFINE_SPINLOCK(g_active_device_lock);
+// merges the reports of all ready devices
+static struct Controller g_controller;
+// configurations of devices seen before, by ControllerId
+static struct ProfileCache g_profile_cache;
+// held while connecting or disconnecting, and while applying profiles
+static DEFINE_MUTEX(g_device_mutex);
+// parent for the profile firmware request
+static struct device *g_root_device = NULL;
 
-// 2 chars, [0] = a char id, [1] = null terminator
-// Index 0 is "\0", empty string... but valid still.
-const char kDeviceName[UGC_MAX_DEVICES][2] = {
-#define UGC_NAME_PT(offset) \
-  {(char)offset+0}, {(char)offset+1}, {(char)offset+2}, {(char)offset+3}, \
-  {(char)offset+4}, {(char)offset+5}, {(char)offset+6}, {(char)offset+7}, \
-  {(char)offset+8}, {(char)offset+9}, {(char)offset+10}, {(char)offset+11}, \
-  {(char)offset+12}, {(char)offset+13}, {(char)offset+14}, {(char)offset+15}
-  UGC_NAME_PT(0x00), UGC_NAME_PT(0x10), UGC_NAME_PT(0x20), UGC_NAME_PT(0x30),
-  UGC_NAME_PT(0x40), UGC_NAME_PT(0x50), UGC_NAME_PT(0x60), UGC_NAME_PT(0x70),
-  UGC_NAME_PT(0x80), UGC_NAME_PT(0x90), UGC_NAME_PT(0xA0), UGC_NAME_PT(0xB0),
-  UGC_NAME_PT(0xC0), UGC_NAME_PT(0xD0), UGC_NAME_PT(0xE0), UGC_NAME_PT(0xF0)
-#undef UGC_NAME_PT
-};
+static int Device_LoadProfile(struct Device *device,
+    const struct Profile *profile, gfp_t gfp);
+static struct Profile *Device_SaveProfile(const struct Device *device);
+static const struct ControllerDbEntry *Device_LoadDefaults(
+    struct Device *device);
+
+static char *profile_firmware = "ugc_profiles.bin";
+module_param(profile_firmware, charp, 0444);
+MODULE_PARM_DESC(profile_firmware, "Firmware file with saved profiles, "
+    "loaded in the background; empty to skip");
+
+static char *merge = "none";
+module_param(merge, charp, 0444);
+MODULE_PARM_DESC(merge, "How ready devices combine: none (the newest or "
+    "last pressed drives the console, the others stand by), or (every "
+    "device contributes all its buttons), priority (the first to bind a "
+    "button owns it)");
+
+static unsigned int axis_press_percent = 50;
+module_param(axis_press_percent, uint, 0444);
+MODULE_PARM_DESC(axis_press_percent, "An EV_ABS direction presses past this "
+    "percent of its travel from the center");
+
+static unsigned int axis_release_percent = 35;
+module_param(axis_release_percent, uint, 0444);
+MODULE_PARM_DESC(axis_release_percent, "An EV_ABS direction releases back "
+    "within this percent of its travel; at most axis_press_percent");
+
+static unsigned int stick_dpad = 0;
+module_param(stick_dpad, uint, 0444);
+MODULE_PARM_DESC(stick_dpad, "Also drive the d-pad from ABS_X/ABS_Y: 4 or 8 "
+    "ways; 0 disables");
+
+static unsigned int stick_dpad_diagonal = 45;
+module_param(stick_dpad_diagonal, uint, 0444);
+MODULE_PARM_DESC(stick_dpad_diagonal, "Degrees of each diagonal sector with "
+    "8 ways");
+
+static unsigned int stick_dpad_deadzone = 50;
+module_param(stick_dpad_deadzone, uint, 0444);
+MODULE_PARM_DESC(stick_dpad_deadzone, "Percent of the stick's radius with no "
+    "direction");
 
-const char* DeviceNameAcquire(struct DeviceGroup* group) {
-  if (group->num_acquired < UGC_MAX_DEVICES) {
-    const int index = find_first_zero_bit(group->acquiredbit, UGC_MAX_DEVICES);
-    set_bit(index, group->acquiredbit);
-    ++group->num_acquired;
-    return kDeviceName[index];
+static char *socd = "none";
+module_param(socd, charp, 0444);
+MODULE_PARM_DESC(socd, "Opposite d-pad directions held together: none, "
+    "neutral, up (Up wins, Left+Right cancel) or last (newest wins)");
+
+// report bits of the d-pad, by UGC_DPAD_* combination
+static struct DpadBits g_dpad_bits;
+static struct StickDpad g_stick_dpad;
+static bool g_is_stick_dpad = false;
+// written by the latch interrupt, or under g_socd_lock in gamepad mode
+static struct Socd g_socd;
+static DEFINE_SPINLOCK(g_socd_lock);
+
+static unsigned int tap_frames[UGC_REPORT_MAX_BITS];
+static unsigned int num_tap_frames = 0;
+module_param_array(tap_frames, uint, &num_tap_frames, 0444);
+MODULE_PARM_DESC(tap_frames, "Frames a press shorter than one frame is "
+    "reported for, per button in report order (one value for all): 0 may "
+    "lose it, 1 (default) or more keep it");
+
+// written by the latch interrupt
+static struct TapCapture g_tap_capture;
+
+static unsigned int turbo_frames[UGC_REPORT_MAX_BITS];
+static unsigned int num_turbo_frames = 0;
+module_param_array(turbo_frames, uint, &num_turbo_frames, 0444);
+MODULE_PARM_DESC(turbo_frames, "Turbo per button in report order: latches "
+    "each held button stays pressed, then released; 0 (default) is off. "
+    "Needs a console latch");
+
+// written by the latch interrupt
+static struct Turbo g_turbo;
+
+static unsigned int bank_hotkey = 0;
+module_param(bank_hotkey, uint, 0644);
+MODULE_PARM_DESC(bank_hotkey, "EV_KEY code that switches binding banks; "
+    "0 disables banks");
+
+static void Device_Delete(struct Device *device);
+
+// Precomputes the thresholds of each EV_ABS axis from its absinfo.
+static int Device_SetupAxes(struct Device *device) {
+  struct input_dev *dev = device->dev;
+  unsigned int code;
+  bool dual_stick;
+  memset(device->axis_index, -1, sizeof(device->axis_index));
+  if (!test_bit(EV_ABS, dev->evbit) || !dev->absinfo) {
+    return 0;
+  }
+  dual_stick = test_bit(ABS_X, dev->absbit) && test_bit(ABS_Y, dev->absbit) &&
+      test_bit(ABS_RX, dev->absbit) && test_bit(ABS_RY, dev->absbit);
+  device->axes = kcalloc(bitmap_weight(dev->absbit, ABS_MT_SLOT),
+      sizeof(*device->axes), GFP_KERNEL);
+  if (!device->axes) {
+    return -ENOMEM;
+  }
+  for_each_set_bit(code, dev->absbit, ABS_MT_SLOT) {
+    Axis_Init(device->axes + device->num_axes, code, dev->absinfo + code,
+        axis_press_percent, axis_release_percent, dual_stick);
+    device->axis_index[code] = device->num_axes++;
   }
-  printk(KERN_DEBUG pr_fmt("Cannot acquire name; max devices reached.\n"));
-  return NULL;
+  return 0;
 }
 
-void DeviceNameRelease(struct DeviceGroup* group, const char* name) {
-  if (test_and_clear_bit(UGC_NAME_TO_INDEX(name), group->acquiredbit)) {
-    --group->num_acquired;
-  } else {
-    printk(KERN_DEBUG pr_fmt("Cannot release name %d; it is not acquired.\n"),
-        UGC_NAME_TO_INDEX(name));
+static struct Device *Device_New(struct input_dev *dev) {
+  struct Device *device = kmem_cache_zalloc(g_device_cache, GFP_KERNEL);
+  if (!device) {
+    return NULL;
+  }
+  device->index = ida_alloc(&g_device_ida, GFP_KERNEL);
+  if (device->index < 0) {
+    kmem_cache_free(g_device_cache, device);
+    return NULL;
+  }
+  device->dev = dev;
+  INIT_LIST_HEAD(&device->ready_node);
+  ControllerId_PopulateFromDev(&device->id, dev);
+  Device_ResetConfig(device);
+  if (Device_SetupAxes(device) != 0) {
+    Device_Delete(device);
+    return NULL;
+  }
+  return device;
+}
+
+static void Device_Delete(struct Device *device) {
+  unsigned int i;
+  for (i = 0; i < UGC_MAX_BANKS; ++i) {
+    kfree(device->banks[i]);
+  }
+  kfree(device->input_nodes);
+  kfree(device->input_state);
+  kfree(device->axes);
+  ControllerId_Clear(&device->id);
+  ida_free(&g_device_ida, device->index);
+  kmem_cache_free(g_device_cache, device);
+}
+
+// Grows input storage to hold count inputs. The tree is rebuilt since its
+// nodes move. Call before the handle is open or with event_lock held.
+static int Device_ReserveInputs(struct Device *device, unsigned int count,
+    gfp_t gfp) {
+  unsigned int capacity, i;
+  struct InputState *nodes;
+  __u32 *state;
+  if (count <= device->input_capacity) {
+    return 0;
+  }
+  if (count > UGC_MAX_INPUTS) {
+    return -ENOSPC;
   }
+  capacity = max(device->input_capacity * 2, UGC_MIN_INPUT_CAPACITY);
+  capacity = clamp_t(unsigned int, capacity, count, UGC_MAX_INPUTS);
+  nodes = kmalloc_array(capacity, sizeof(*nodes), gfp);
+  state = kcalloc(capacity, sizeof(*state), gfp);
+  if (!nodes || !state) {
+    kfree(nodes);
+    kfree(state);
+    return -ENOMEM;
+  }
+  device->input_code_to_index = RB_ROOT;
+  for (i = 0; i < device->num_inputs; ++i) {
+    nodes[i] = device->input_nodes[i];
+    state[i] = device->input_state[i];
+    InputState_Insert(&device->input_code_to_index, nodes + i);
+  }
+  kfree(device->input_nodes);
+  kfree(device->input_state);
+  device->input_nodes = nodes;
+  device->input_state = state;
+  device->input_capacity = capacity;
+  return 0;
+}
+
+// Allocates a bank on first use and clears it.
+static int Device_ReserveBank(struct Device *device, unsigned int bank,
+    gfp_t gfp) {
+  if (!device->banks[bank]) {
+    device->banks[bank] = kmalloc(sizeof(*device->banks[bank]), gfp);
+    if (!device->banks[bank]) {
+      return -ENOMEM;
+    }
+  }
+  BindingTable_Init(device->banks[bank]);
+  return 0;
 }
 
 static irqreturn_t SnesLatchChangedInterrupt(int irq, void *dev_id);
 static irqreturn_t SnesClockRisingInterrupt(int irq, void *dev_id);
+static irqreturn_t PowerChangedInterrupt(int irq, void *dev_id);
+static irqreturn_t SnesLatchWakeInterrupt(int irq, void *dev_id);
 
 static struct PinConfig g_snes_data = {
   .label = "snes_data",
@@ -127,19 +362,206 @@ static struct PinConfig g_snes_latch = {
   .input_irq_flags = IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,  // rising too? to store inputs
   .input_irq_handler = SnesLatchChangedInterrupt,
 };
+// the console's VCC, through a divider; pin_number from power_pin
+static struct PinConfig g_snes_power = {
+  .label = "snes_power",
+  .direction = kInput,
+  .input_irq_flags = IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,
+  .input_irq_handler = PowerChangedInterrupt,
+};
+
+static int power_pin = -1;
+module_param(power_pin, int, 0444);
+MODULE_PARM_DESC(power_pin, "GPIO reading the console's power, high when "
+    "on; idles while it's low. -1 (default) for none");
+static bool g_is_power_pin = false;
 
-#define SNES_CYCLE_COUNT 16
-static const unsigned int kSnesCycleCount = SNES_CYCLE_COUNT;
-static bool g_latched_state[SNES_CYCLE_COUNT] = {0};
-static unsigned int g_cycle_index = SNES_CYCLE_COUNT;
+static unsigned int idle_timeout_ms = 0;
+module_param(idle_timeout_ms, uint, 0444);
+MODULE_PARM_DESC(idle_timeout_ms, "Idle after this long without a latch; "
+    "0 (default) never");
+
+// While idle the clock interrupt is disabled and EventHandler drops events,
+// leaving the input core's own key and absinfo state as the only record.
+// A power-up, or a latch while powered, resumes: the clock is re-armed
+// before the latch falls, and devices are read back from that state.
+static atomic_t g_is_idle = ATOMIC_INIT(0);
+static void ResyncDevices(struct work_struct *work);
+static DECLARE_WORK(g_resync_work, ResyncDevices);
+static void IdleCheck(struct work_struct *work);
+static DECLARE_DELAYED_WORK(g_idle_check, IdleCheck);
+// as of the last IdleCheck
+static u64 g_idle_check_latches = 0;
+
+// Safe from any context. The poll engine has no clock interrupt; its
+// thread sleeps instead.
+static void EnterIdle(void) {
+  if (atomic_cmpxchg(&g_is_idle, 0, 1) == 0 &&
+      PinConfig_HasInterrupt(&g_snes_clock)) {
+    disable_irq_nosync(g_snes_clock.input_irq_number);
+  }
+}
+
+// Safe from any context.
+static void ResumeFromIdle(void) {
+  if (atomic_cmpxchg(&g_is_idle, 1, 0) == 1) {
+    if (PinConfig_HasInterrupt(&g_snes_clock)) {
+      enable_irq(g_snes_clock.input_irq_number);
+    }
+    schedule_work(&g_resync_work);
+  }
+}
+
+// Safe from any context. A latch seen while the power pin reads low is
+// noise, or the console's rails going down, and doesn't resume.
+static void ResumeFromLatch(void) {
+  if (g_is_power_pin && !gpio_get_value(g_snes_power.pin_number)) {
+    return;
+  }
+  ResumeFromIdle();
+}
+
+static char *engine = "irq";
+module_param(engine, charp, 0444);
+MODULE_PARM_DESC(engine, "What answers the console: irq (default), or poll "
+    "for a thread spinning on the latch and clock lines, woken by the "
+    "latch interrupt when it has slept");
+
+static int poll_cpu = -1;
+module_param(poll_cpu, int, 0444);
+MODULE_PARM_DESC(poll_cpu, "CPU the poll engine runs on, required with "
+    "engine=poll; it must be isolated (isolcpus=), since the engine never "
+    "yields it");
+
+static bool edge_histogram = false;
+module_param(edge_histogram, bool, 0644);
+MODULE_PARM_DESC(edge_histogram, "Record the poll engine's edge response "
+    "times in the stats file; the irq engine has no edge timestamp and "
+    "records none");
+
+static char *clock_irq = "";
+module_param(clock_irq, charp, 0444);
+MODULE_PARM_DESC(clock_irq, "How the clock interrupt is serviced, e.g. "
+    "nothread,nobalancing,priority=90,cpus=3; the result is logged at load. "
+    "engine=irq only");
+
+static char *latch_irq = "";
+module_param(latch_irq, charp, 0444);
+MODULE_PARM_DESC(latch_irq, "How the latch interrupt is serviced; as "
+    "clock_irq");
+
+// Spinning through a stretch with no latch this long, the poll engine
+// sleeps until the next one.
+static const u64 kPollSleepNs = 100 * NSEC_PER_MSEC;
+static struct task_struct *g_poll_thread = NULL;
+// the latch interrupt is enabled to wake the sleeping thread
+static atomic_t g_is_poll_armed = ATOMIC_INIT(0);
+
+// Pins wired to a real pad, for reading it rather than being it.
+static struct PadReader g_pad_reader = {
+  .latch = {
+    .label = "pad_latch",
+    .pin_number = 16,  // BCM 23
+    .direction = kOutput,
+    .output_value = kLow,
+  },
+  .clock = {
+    .label = "pad_clock",
+    .pin_number = 18,  // BCM 24
+    .direction = kOutput,
+    .output_value = kHigh,
+  },
+  .data = {
+    .label = "pad_data",
+    .pin_number = 22,  // BCM 25
+    .direction = kInput,
+  },
+};
+
+static struct Interposer g_interposer;
+static struct GamepadOutput g_gamepad_output;
+// /dev/ugc_state; written by the latch, or under g_socd_lock in gamepad mode
+static struct StatePage g_state_page;
+
+static char *inject = "off";
+module_param(inject, charp, 0444);
+MODULE_PARM_DESC(inject, "Buttons written to /dev/ugc_inject's page: off "
+    "(default, no device), or (pressed as well) or override (replace "
+    "devices' for the page's mask bits). Needs a console latch");
+static struct Inject g_inject;
+
+static unsigned int tas_frames = 0;
+module_param(tas_frames, uint, 0444);
+MODULE_PARM_DESC(tas_frames, "Report words /dev/ugc_tas can queue for "
+    "playback, one per latch, at most 1048576; 0 (default) for no device. "
+    "Needs a console latch");
+static struct Tas g_tas;
+
+enum Mode {
+  kModeConsole = 0, kModeReader, kModeInterposer, kModeGamepad
+};
+static enum Mode g_mode;
+
+static char *mode = "console";
+module_param(mode, charp, 0444);
+MODULE_PARM_DESC(mode, "console: be a pad for the console; "
+    "reader: publish a real pad as an input device; "
+    "interposer: be a pad for the console, merging in a real pad; "
+    "gamepad: publish the mapped controller as an input device");
+
+static char *pad_format = "standard";
+module_param(pad_format, charp, 0444);
+MODULE_PARM_DESC(pad_format, "Pad read in reader mode: nes, standard or "
+    "ntt_keypad");
+
+static unsigned int pad_poll_rate = 250;
+module_param(pad_poll_rate, uint, 0444);
+MODULE_PARM_DESC(pad_poll_rate, "Reader mode polls per second");
+
+static unsigned int interposer_lead_us = 500;
+module_param(interposer_lead_us, uint, 0444);
+MODULE_PARM_DESC(interposer_lead_us, "Interposer mode finishes reading the "
+    "pad this long before the predicted console latch");
+
+static char *report_format = "standard";
+module_param(report_format, charp, 0444);
+MODULE_PARM_DESC(report_format,
+    "Report sent to the console: standard (16 bit) or ntt_keypad (32 bit)");
+
+static const struct SnesReportFormat *g_report_format;
+// Data line levels still to be sent, LSB first; zero once exhausted.
+static u64 g_latched_line = 0;
 //static bool g_latch_state_known = false;
 static enum PinState g_latch_state;
 
 
 static inline void SnesSendNextButton(void) {
-  gpio_set_value(g_snes_data.pin_number,
-      (int)g_latched_state[g_cycle_index]);
-  ++g_cycle_index;
+  gpio_set_value(g_snes_data.pin_number, (int)(g_latched_line & 1));
+  g_latched_line >>= 1;
+}
+
+// Rising edge: saves the report for the clocks to shift out. Called by the
+// running engine only.
+static void SnesLatchRise(void) {
+  u64 taps;
+  u64 pressed = Controller_LatchTaps(&g_controller, &taps);
+  if (g_mode == kModeInterposer) {
+    pressed |= Interposer_Latch(&g_interposer, ktime_get());
+  }
+  if (g_inject.policy != kInjectOff) {
+    pressed = Inject_Latch(&g_inject, pressed, &taps);
+  }
+  pressed = TapCapture_Latch(&g_tap_capture, pressed, taps);
+  pressed = Turbo_Latch(&g_turbo, pressed);
+  pressed = Socd_Resolve(&g_socd, pressed);
+  // a movie's words are sent exactly as recorded
+  if (Tas_IsPlaying(&g_tas)) {
+    pressed = Tas_Latch(&g_tas, pressed);
+  }
+  g_latched_line = SnesReportFormat_LineWord(g_report_format, pressed);
+  ++g_stats.latches;
+  StatePage_Publish(&g_state_page, pressed, READ_ONCE(g_active_index),
+      ktime_get_ns());
 }
 
 static irqreturn_t SnesLatchChangedInterrupt(int irq, void *dev_id) {
@@ -154,18 +576,13 @@ static irqreturn_t SnesLatchChangedInterrupt(int irq, void *dev_id) {
   //} else {
   //  g_latch_state = (enum PinState)(!g_latch_state);
   //}
+  if (unlikely(atomic_read(&g_is_idle))) {
+    ResumeFromLatch();
+  }
 
   // timing is less strict for the rise than the fall
   if (unlikely(g_latch_state)) {
-    // TODO: optimize this?
-    const __u32 * const current_state = g_active_device->input_state;
-    // rising edge: save state, initialize offset
-    int i;
-    for (i=0; i < kSnesCycleCount; ++i) {
-      // For SNES, pressed == low, so inverting the check.
-      g_latched_state[i] = (current_state[i] <= kPressedThreshold);
-    }
-    g_cycle_index = 0;
+    SnesLatchRise();
   } else {
     // send first button state
     SnesSendNextButton();
@@ -179,17 +596,114 @@ static irqreturn_t SnesClockRisingInterrupt(int irq, void *dev_id) {
   unsigned long flags;
   // disable hard interrupts (remember them in flag 'flags')
   local_irq_save(flags);
-  if (likely(g_cycle_index < kSnesCycleCount)) {
-    // send next button state
-    SnesSendNextButton();
-  } else {
-    gpio_set_value(g_snes_data.pin_number, (int)kLow);
-  }
+  // send next button state; low once the report is exhausted
+  SnesSendNextButton();
   // restore hard interrupts
   local_irq_restore(flags);
   return IRQ_HANDLED;
 }
 
+// The poll engine's latch interrupt, enabled only while its thread sleeps.
+static irqreturn_t SnesLatchWakeInterrupt(int irq, void *dev_id) {
+  // the thread may wake after the pulse has ended and see no edge; while
+  // idle it would then sleep again, so the resume can't be left to it
+  if (unlikely(atomic_read(&g_is_idle))) {
+    ResumeFromLatch();
+  }
+  if (atomic_xchg(&g_is_poll_armed, 0)) {
+    disable_irq_nosync(irq);
+    wake_up_process(g_poll_thread);
+  }
+  return IRQ_HANDLED;
+}
+
+// Sleeps until a latch edge, or until stopped.
+static void SnesPollSleep(void) {
+  set_current_state(TASK_INTERRUPTIBLE);
+  atomic_set(&g_is_poll_armed, 1);
+  enable_irq(g_snes_latch.input_irq_number);
+  if (!kthread_should_stop()) {
+    schedule();
+  }
+  __set_current_state(TASK_RUNNING);
+  if (atomic_xchg(&g_is_poll_armed, 0)) {
+    // woken by something other than the latch
+    disable_irq(g_snes_latch.input_irq_number);
+  }
+}
+
+// The poll engine. Each pass samples both lines and answers an edge at
+// once. Response is bounded by the time since the previous pass, which is
+// what the histogram records.
+static int SnesPollThread(void *data) {
+  int latch = 0;  // a latch already high when woken counts as a rise
+  int clock = gpio_get_value(g_snes_clock.pin_number);
+  u64 sample_ns = ktime_get_ns();
+  u64 edge_ns = sample_ns;
+  while (!kthread_should_stop()) {
+    unsigned long flags;
+    int latch_now, clock_now;
+    u64 now_ns;
+    bool is_edge = true;
+    // as in the interrupt engine, nothing comes between sample and answer
+    local_irq_save(flags);
+    latch_now = gpio_get_value(g_snes_latch.pin_number) != 0;
+    clock_now = gpio_get_value(g_snes_clock.pin_number) != 0;
+    now_ns = ktime_get_ns();
+    if (latch_now != latch) {
+      if (unlikely(atomic_read(&g_is_idle))) {
+        ResumeFromLatch();
+      }
+      latch = latch_now;
+      edge_ns = now_ns;
+      if (latch) {
+        SnesLatchRise();
+      } else {
+        SnesSendNextButton();
+      }
+    } else if (clock_now && !clock) {
+      SnesSendNextButton();
+    } else {
+      is_edge = false;
+    }
+    if (is_edge && unlikely(edge_histogram)) {
+      Stats_RecordEdge(ktime_get_ns() - sample_ns);
+    }
+    local_irq_restore(flags);
+    clock = clock_now;
+    sample_ns = now_ns;
+    if (unlikely(now_ns - edge_ns > kPollSleepNs ||
+        atomic_read(&g_is_idle))) {
+      SnesPollSleep();
+      latch = 0;
+      clock = gpio_get_value(g_snes_clock.pin_number) != 0;
+      sample_ns = edge_ns = ktime_get_ns();
+    }
+    // lets RCU see a quiescent state on a CPU this thread never leaves
+    cond_resched();
+  }
+  return 0;
+}
+
+static irqreturn_t PowerChangedInterrupt(int irq, void *dev_id) {
+  if (gpio_get_value(g_snes_power.pin_number)) {
+    ResumeFromIdle();
+  } else {
+    EnterIdle();
+  }
+  return IRQ_HANDLED;
+}
+
+// Runs every idle_timeout_ms; a period without a latch idles.
+static void IdleCheck(struct work_struct *work) {
+  const u64 latches = READ_ONCE(g_stats.latches);
+  if (latches == g_idle_check_latches) {
+    EnterIdle();
+  }
+  g_idle_check_latches = latches;
+  schedule_delayed_work(&g_idle_check, msecs_to_jiffies(idle_timeout_ms));
+}
+
 
 #include <asm/div64.h>
 // scales the value into the range of a __u32
@@ -215,73 +729,689 @@ __u32 NormalizeValue(__s32 value, __s32 low, __s32 high) {
 }
 
 
+// Makes device the active one and, under kMergeReplace, the controller's
+// only member. With standby set, only a device waiting on the ready list
+// takes over.
+static void Device_TakeOver(struct Device *device, bool standby) {
+  unsigned long flags;
+  spin_lock_irqsave(&g_active_device_lock, flags);
+  if (standby && (list_empty(&device->ready_node) ||
+      g_active_device == device)) {
+    spin_unlock_irqrestore(&g_active_device_lock, flags);
+    return;
+  }
+  list_move_tail(&device->ready_node, &g_ready_devices);
+  g_active_device = device;
+  WRITE_ONCE(g_active_index, device->index);
+  if (Controller_Add(&g_controller, &device->report, &device->taps,
+      device->bound) != 0) {
+    printk(KERN_DEBUG pr_fmt("Cannot merge device; controller full.\n"));
+  }
+  spin_unlock_irqrestore(&g_active_device_lock, flags);
+}
+
+// Gamepad mode: republishes the merged controller, as a latch would.
+static void CommitGamepad(void) {
+  unsigned long flags;
+  u64 pressed;
+  spin_lock_irqsave(&g_socd_lock, flags);
+  pressed = Socd_Resolve(&g_socd, Controller_Latch(&g_controller));
+  GamepadOutput_Commit(&g_gamepad_output, pressed);
+  StatePage_Publish(&g_state_page, pressed, READ_ONCE(g_active_index),
+      ktime_get_ns());
+  spin_unlock_irqrestore(&g_socd_lock, flags);
+}
+
+// Takes the device off the controller before it's reset or freed. If it
+// was active, the newest standby is published in the same update, so no
+// latch sees neither; when the device is disconnecting under kMergeReplace
+// that handover is a failover, counted and timed through the publish.
+// Call with g_device_mutex held; may sleep.
+static void Device_Deactivate(struct Device *device, bool disconnecting) {
+  const ktime_t start = ktime_get();
+  struct Device *next = NULL;
+  unsigned long flags;
+  s64 elapsed_ns;
+  spin_lock_irqsave(&g_active_device_lock, flags);
+  list_del_init(&device->ready_node);
+  if (g_active_device == device) {
+    next = list_last_entry_or_null(&g_ready_devices, struct Device,
+        ready_node);
+    g_active_device = next;
+    WRITE_ONCE(g_active_index, next ? next->index : -1);
+  }
+  if (next && g_controller.policy == kMergeReplace) {
+    // presses made while standing by aren't taps now
+    atomic64_set(&next->taps, 0);
+    if (Controller_Add(&g_controller, &next->report, &next->taps,
+        next->bound) != 0) {
+      printk(KERN_DEBUG pr_fmt("Cannot fail over to device %d.\n"),
+          next->index);
+    }
+  }
+  spin_unlock_irqrestore(&g_active_device_lock, flags);
+  Controller_Remove(&g_controller, &device->report);
+  if (next && disconnecting && g_controller.policy == kMergeReplace) {
+    elapsed_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+    ++g_stats.failovers;
+    g_stats.failover_ns_last = elapsed_ns;
+    g_stats.failover_ns_max = max(g_stats.failover_ns_max, elapsed_ns);
+    printk(KERN_DEBUG pr_fmt("Failed over from device %d to %d.\n"),
+        device->index, next->index);
+  }
+}
+
 static int ConnectDevice(struct input_handler *handler, struct input_dev *dev,
     const struct input_device_id *id) {
   struct input_handle *handle;
   int error;
   const char* bus_name;
-  const char* device_name;
+  struct Device *device;
+  const struct Profile *profile;
+  const struct ControllerDbEntry *db_entry = NULL;
+  bool loaded = false;
+  if (dev == g_gamepad_output.input || dev == g_pad_reader.input) {
+    // mapping our own outputs would feed them back into themselves
+    return -ENODEV;
+  }
   handle = kzalloc(sizeof(struct input_handle), GFP_KERNEL);
   if (!handle) {
     return -ENOMEM;
   }
 
-  device_name = DeviceNameAcquire(&g_device_group);
-  if (!device_name) {
-    printk(KERN_DEBUG pr_fmt("Device connected, but no names available.\n"));
-    return 0;
+  mutex_lock(&g_device_mutex);
+  device = Device_New(dev);
+  if (!device) {
+    error = -ENOMEM;
+    goto err_free_handle;
   }
   handle->dev = dev;
   handle->handler = handler;
-  handle->name = device_name;
+  handle->name = HANDLER_NAME;
+  handle->private = device;
+
+  // configured before events can arrive
+  mutex_lock(&g_profile_cache.lock);
+  profile = ProfileCache_Find(&g_profile_cache, &device->id);
+  if (profile) {
+    loaded = Device_LoadProfile(device, profile, GFP_KERNEL) == 0;
+  }
+  mutex_unlock(&g_profile_cache.lock);
+  if (!profile) {
+    db_entry = Device_LoadDefaults(device);
+  }
 
   error = input_register_handle(handle);
   if (error)
-    goto err_free_handle;
+    goto err_delete_device;
 
   error = input_open_device(handle);
   if (error)
     goto err_unregister_handle;
-
-  Device_ResetConfig(g_devices + UGC_NAME_TO_INDEX(device_name), dev);
+  list_add_tail(&device->node, &g_devices);
+  mutex_unlock(&g_device_mutex);
 
   GetBusName(dev->id.bustype, &bus_name);
 
-  printk(KERN_DEBUG pr_fmt("Connected device: [%s] %s (%s) at %s\n"),
+  printk(KERN_DEBUG pr_fmt("Connected device %d: [%s] %s (%s) at %s%s%s%s\n"),
+      device->index,
       bus_name,
       dev->name ?: "unknown",
       dev->uniq ?: "unknown",
-      dev->phys ?: "unknown");
+      dev->phys ?: "unknown",
+      loaded ? ", profile loaded" : "",
+      db_entry ? ", defaults for " : "",
+      db_entry ? db_entry->name : "");
 
   return 0;
 
 err_unregister_handle:
   input_unregister_handle(handle);
+err_delete_device:
+  Device_Deactivate(device, false);
+  // the latch may still be reading the old member set
+  synchronize_rcu();
+  Device_Delete(device);
 err_free_handle:
+  mutex_unlock(&g_device_mutex);
   kfree(handle);
   return error;
 }
 
 static void DisconnectDevice(struct input_handle *handle)
 {
+  struct Device *device = handle->private;
   const char* bus_name;
   GetBusName(handle->dev->id.bustype, &bus_name);
 
-  // no need to cleanup the device itself; all storage is static and
-  // it is cleared when reused
-  DeviceNameRelease(&g_device_group, handle->name);
+  // no more events after this
+  input_close_device(handle);
+
+  mutex_lock(&g_device_mutex);
+  list_del(&device->node);
+  Device_Deactivate(device, true);
+  if (g_mode == kModeGamepad) {
+    // nothing else releases what the device held
+    CommitGamepad();
+  }
+  if (device->config_state == kReady) {
+    struct Profile *profile = Device_SaveProfile(device);
+    if (profile) {
+      ProfileCache_Store(&g_profile_cache, profile);
+    }
+  }
+  mutex_unlock(&g_device_mutex);
 
-  printk(KERN_DEBUG pr_fmt("Disconnected device: [%s] %s (%s) at %s\n"),
+  printk(KERN_DEBUG pr_fmt("Disconnected device %d: [%s] %s (%s) at %s\n"),
+      device->index,
       bus_name,
       handle->dev->name ?: "unknown",
       handle->dev->uniq ?: "unknown",
       handle->dev->phys ?: "unknown");
 
-  input_close_device(handle);
+  // the latch may still be reading the old member set
+  synchronize_rcu();
+  Device_Delete(device);
   input_unregister_handle(handle);
   kfree(handle);
 }
 
+static inline void Device_SetRaw(struct Device *device, unsigned int input,
+    bool pressed) {
+  if (pressed) {
+    device->raw |= BIT_ULL(input);
+  } else {
+    device->raw &= ~BIT_ULL(input);
+  }
+}
+
+// Publishes the report for the device's current frame of input.
+static void Device_Commit(struct Device *device) {
+  struct ugc_bpf_ctx frame = {
+    .raw = device->raw,
+    .report = BindingTable_Evaluate(READ_ONCE(device->table), device->raw) |
+        g_dpad_bits.bits[device->stick_direction],
+    .device = device->index,
+    .bank = device->active_bank,
+    .stick = device->stick_direction,
+    .inputs = &device->input_code_to_index,
+  };
+  const u64 report = MappingBpf_Frame(&frame);
+  const u64 taps = report & ~atomic64_read(&device->report);
+  device->published_raw = device->raw;
+  device->published_stick_direction = device->stick_direction;
+  // taps first, so a latch between the two can't report a press twice
+  if (taps) {
+    atomic64_or(taps, &device->taps);
+  }
+  atomic64_set(&device->report, report);
+  // under kMergeReplace a standby takes over when pressed
+  if (unlikely(taps && g_controller.policy == kMergeReplace &&
+      READ_ONCE(g_active_device) != device)) {
+    Device_TakeOver(device, true);
+  }
+  if (g_mode == kModeGamepad) {
+    CommitGamepad();
+  }
+}
+
+static inline bool Device_HasStick(const struct Device *device) {
+  return device->axis_index[ABS_X] >= 0 && device->axis_index[ABS_Y] >= 0;
+}
+
+static inline void Device_UpdateStick(struct Device *device) {
+  if (g_is_stick_dpad && Device_HasStick(device)) {
+    device->stick_direction = StickDpad_Direction(&g_stick_dpad,
+        device->axes + device->axis_index[ABS_X],
+        device->axes + device->axis_index[ABS_Y]);
+  }
+}
+
+// Rebuilds raw and the stick from the input core's key and absinfo state
+// rather than from events: one test per bound input and one update per
+// axis. Axes restart their hysteresis, so only a press threshold counts.
+// Call with event_lock held or before the handle is open.
+static void Device_Resync(struct Device *device) {
+  const struct input_dev *dev = device->dev;
+  unsigned int code, i;
+  u64 raw = 0;
+  if (device->num_axes) {
+    for_each_set_bit(code, dev->absbit, ABS_MT_SLOT) {
+      struct Axis *axis = device->axes + device->axis_index[code];
+      axis->pressed = 0;
+      Axis_Update(axis, dev->absinfo[code].value);
+    }
+  }
+  for (i = 0; i < device->num_inputs; ++i) {
+    const struct InputState *node = device->input_nodes + i;
+    bool pressed = false;
+    if (node->type == EV_KEY) {
+      pressed = node->code < KEY_CNT && test_bit(node->code, dev->key);
+    } else if (node->type == EV_ABS && node->code < ABS_MT_SLOT &&
+        device->axis_index[node->code] >= 0) {
+      pressed = device->axes[device->axis_index[node->code]].pressed &
+          (node->positive ? UGC_AXIS_POSITIVE : UGC_AXIS_NEGATIVE);
+    }
+    // EV_REL has no state to read; motion is never held
+    device->input_state[i] = pressed ? U32_MAX : 0;
+    raw |= (u64)pressed << i;
+  }
+  device->raw = raw;
+  Device_UpdateStick(device);
+}
+
+// A switch is one pointer store. The report is republished right away, so
+// the next latch already sees the new bank.
+static void Device_SelectBank(struct Device *device, unsigned int bank) {
+  device->active_bank = bank;
+  WRITE_ONCE(device->table, device->banks[bank]);
+  Device_Commit(device);
+  printk(KERN_DEBUG pr_fmt("Bank: %u\n"), bank);
+}
+
+static void Device_StartBank(struct Device *device, unsigned int bank) {
+  if (Device_ReserveBank(device, bank, GFP_ATOMIC) != 0) {
+    printk(KERN_DEBUG pr_fmt("Cannot allocate bank %u.\n"), bank);
+    return;
+  }
+  device->editing_bank = bank;
+  device->count = 0;
+  device->pending = 0;
+  // the hotkey, not a terminal input, ends a bank configured when ready
+  device->last_input = (struct InputState) { 0 };
+}
+
+static void Device_Activate(struct Device *device) {
+  device->config_state = kReady;
+  device->table = device->banks[device->active_bank];
+  if (g_is_stick_dpad && Device_HasStick(device)) {
+    device->bound |= DpadBits_All(&g_dpad_bits);
+  }
+  // inputs already held count from the first latch
+  Device_Resync(device);
+  Device_Commit(device);
+  // the previous device stays ready, standing by
+  Device_TakeOver(device, false);
+}
+
+// Returns the raw bit of input, adding it when new; -1 if out of space.
+static int Device_InputIndex(struct Device *device,
+    const struct InputState *input) {
+  struct InputState *node = InputState_Search(
+      &device->input_code_to_index, (struct InputState *)input);
+  if (node) {
+    return node->value;
+  }
+  if (Device_ReserveInputs(device, device->num_inputs + 1, GFP_ATOMIC) != 0) {
+    return -1;
+  }
+  node = device->input_nodes + device->num_inputs;
+  *node = *input;
+  node->value = device->num_inputs++;
+  InputState_Insert(&device->input_code_to_index, node);
+  return node->value;
+}
+
+static void Device_FinishBank(struct Device *device) {
+  const unsigned int bank = device->editing_bank;
+  BindingTable_Compile(device->banks[bank]);
+  device->editing_bank = UGC_NO_BANK;
+  device->num_banks = bank + 1;
+  if (device->config_state == kReady) {
+    unsigned long flags;
+    Device_SelectBank(device, bank);
+    // the member was published with the bound of its earlier banks
+    spin_lock_irqsave(&g_active_device_lock, flags);
+    Controller_Update(&g_controller, &device->report, device->bound);
+    spin_unlock_irqrestore(&g_active_device_lock, flags);
+  } else {
+    Device_Activate(device);
+  }
+}
+
+// Storage is allocated with gfp, so the device is left unconfigured if
+// that fails.
+static int Device_LoadProfile(struct Device *device,
+    const struct Profile *profile, gfp_t gfp) {
+  unsigned int i, j;
+  int result = Device_ReserveInputs(device, profile->num_inputs, gfp);
+  // bank 0 is the table even when the profile has none
+  for (i = 0; result == 0 && i < max(profile->num_banks, 1u); ++i) {
+    result = Device_ReserveBank(device, i, gfp);
+  }
+  if (result != 0) {
+    return result;
+  }
+  for (i = 0; i < profile->num_inputs; ++i) {
+    struct InputState *node = device->input_nodes + i;
+    *node = (struct InputState) {
+      .type = profile->input[i].type,
+      .code = profile->input[i].code,
+      .positive = profile->input[i].positive,
+      .value = i,
+    };
+    InputState_Insert(&device->input_code_to_index, node);
+  }
+  device->num_inputs = profile->num_inputs;
+  for (i = 0; i < profile->num_banks; ++i) {
+    *device->banks[i] = profile->banks[i];
+  }
+  device->num_banks = profile->num_banks;
+  device->bound = 0;
+  for (i = 0; i < profile->num_banks; ++i) {
+    for (j = 0; j < profile->banks[i].num_rules; ++j) {
+      device->bound |= profile->banks[i].rule[j].output;
+    }
+  }
+  device->editing_bank = UGC_NO_BANK;
+  Device_Activate(device);
+  return 0;
+}
+
+static struct Profile *Device_SaveProfile(const struct Device *device) {
+  struct Profile *profile = Profile_New();
+  unsigned int i;
+  if (!profile) {
+    return NULL;
+  }
+  ControllerId_Set(&profile->id, device->id.name, device->id.uniq,
+      device->id.phys, device->id.bustype);
+  profile->num_inputs = device->num_inputs;
+  for (i = 0; i < device->num_inputs; ++i) {
+    profile->input[i] = (struct ProfileInput) {
+      .type = device->input_nodes[i].type,
+      .code = device->input_nodes[i].code,
+      .positive = device->input_nodes[i].positive,
+    };
+  }
+  // a bank still being configured is dropped
+  profile->num_banks = device->num_banks;
+  for (i = 0; i < device->num_banks; ++i) {
+    profile->banks[i] = *device->banks[i];
+  }
+  return profile;
+}
+
+// Whether dev has every input entry binds. Pads such as the DualShock 4
+// register their touchpad and motion sensors under the pad's own id, and
+// those must not be mapped as the pad.
+static bool Device_HasInputs(struct input_dev *dev,
+    const struct ControllerDbEntry *entry) {
+  unsigned int i;
+  for (i = 0; i < entry->num_inputs; ++i) {
+    const struct ControllerDbInput *input = entry->inputs + i;
+    bool has;
+    switch (input->type) {
+      case EV_KEY:
+        has = IsBitmapSet(input->code, dev->keybit, KEY_MAX);
+        break;
+      case EV_ABS:
+        has = IsBitmapSet(input->code, dev->absbit, ABS_MAX);
+        break;
+      case EV_REL:
+        has = IsBitmapSet(input->code, dev->relbit, REL_MAX);
+        break;
+      default:
+        has = false;
+    }
+    if (!has) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Readies a device from the built-in database, if it's listed there.
+static const struct ControllerDbEntry *Device_LoadDefaults(
+    struct Device *device) {
+  const struct input_id *id = &device->dev->id;
+  const struct ControllerDbEntry *entry;
+  struct Profile *profile;
+  entry = ControllerDb_Find(id->vendor, id->product, id->version);
+  if (!entry || !Device_HasInputs(device->dev, entry)) {
+    return NULL;
+  }
+  profile = Profile_New();
+  if (!profile) {
+    return NULL;
+  }
+  ControllerDb_ToProfile(entry, g_report_format, profile);
+  if (Device_LoadProfile(device, profile, GFP_KERNEL) != 0) {
+    entry = NULL;
+  }
+  Profile_Delete(profile);
+  return entry;
+}
+
+// Call with g_device_mutex held. A ready device leaves the controller
+// first, since removal may sleep.
+static void Device_ApplyProfile(struct Device *device,
+    const struct Profile *profile) {
+  unsigned long flags;
+  if (device->config_state == kReady) {
+    Device_Deactivate(device, false);
+  }
+  // serializes with EventHandler, which runs under event_lock
+  spin_lock_irqsave(&device->dev->event_lock, flags);
+  Device_ResetConfig(device);
+  if (Device_LoadProfile(device, profile, GFP_ATOMIC) != 0) {
+    printk(KERN_DEBUG pr_fmt("Cannot apply profile to device %d.\n"),
+        device->index);
+  }
+  spin_unlock_irqrestore(&device->dev->event_lock, flags);
+}
+
+// Applies freshly loaded profiles to devices that are still unconfigured.
+static void ApplyProfiles(void) {
+  struct Device *device;
+  mutex_lock(&g_device_mutex);
+  mutex_lock(&g_profile_cache.lock);
+  list_for_each_entry(device, &g_devices, node) {
+    const struct Profile *profile;
+    if (device->config_state != kConnected) {
+      continue;
+    }
+    profile = ProfileCache_Find(&g_profile_cache, &device->id);
+    if (profile) {
+      Device_ApplyProfile(device, profile);
+    }
+  }
+  mutex_unlock(&g_profile_cache.lock);
+  mutex_unlock(&g_device_mutex);
+}
+
+// Applies the profile just stored for id to every device with that id,
+// replacing whatever configuration it has.
+static void ApplyProfile(const struct ControllerId *id) {
+  const struct Profile *profile;
+  struct Device *device;
+  mutex_lock(&g_device_mutex);
+  mutex_lock(&g_profile_cache.lock);
+  profile = ProfileCache_Find(&g_profile_cache, id);
+  list_for_each_entry(device, &g_devices, node) {
+    if (profile && ControllerId_Equal(&device->id, id)) {
+      Device_ApplyProfile(device, profile);
+    }
+  }
+  mutex_unlock(&g_profile_cache.lock);
+  mutex_unlock(&g_device_mutex);
+}
+
+// Reads every ready device back from the input core's state, after idle.
+static void ResyncDevices(struct work_struct *work) {
+  struct Device *device;
+  unsigned long flags;
+  mutex_lock(&g_device_mutex);
+  list_for_each_entry(device, &g_devices, node) {
+    spin_lock_irqsave(&device->dev->event_lock, flags);
+    if (device->config_state == kReady &&
+        device->editing_bank == UGC_NO_BANK) {
+      device->stale = false;
+      Device_Resync(device);
+      Device_Commit(device);
+    }
+    spin_unlock_irqrestore(&device->dev->event_lock, flags);
+  }
+  mutex_unlock(&g_device_mutex);
+}
+
+static struct ProfileConfigfs g_profile_configfs = {
+  .cache = &g_profile_cache,
+  .applied = ApplyProfile,
+};
+
+static void ProfileFirmwareLoaded(const struct firmware *firmware,
+    void *context) {
+  int result;
+  if (!firmware) {
+    printk(KERN_DEBUG pr_fmt("No profile firmware: %s\n"), profile_firmware);
+    return;
+  }
+  result = ProfileCache_LoadBlob(&g_profile_cache, firmware->data,
+      firmware->size);
+  release_firmware(firmware);
+  if (result < 0) {
+    printk(KERN_DEBUG pr_fmt("Invalid profile firmware: %d\n"), result);
+    return;
+  }
+  printk(KERN_DEBUG pr_fmt("Loaded %d profiles\n"), result);
+  ApplyProfiles();
+}
+
+static void Device_BankHotkey(struct Device *device) {
+  const unsigned int next = device->active_bank + 1;
+  if (device->editing_bank != UGC_NO_BANK) {
+    if (device->count) {
+      Device_FinishBank(device);
+    } else {
+      // nothing bound; abandon it and wrap around
+      device->editing_bank = UGC_NO_BANK;
+      Device_SelectBank(device, 0);
+    }
+  } else if (next < device->num_banks) {
+    Device_SelectBank(device, next);
+  } else if (device->num_banks < UGC_MAX_BANKS) {
+    Device_StartBank(device, device->num_banks);
+  } else {
+    Device_SelectBank(device, 0);
+  }
+}
+
+static void Device_Configure(struct Device *device,
+    const struct InputState *input, bool pressed) {
+  const int index = Device_InputIndex(device, input);
+  bool is_terminal;
+  u64 inputs;
+  if (index < 0) {
+    return;
+  }
+  device->input_state[index] = input->value;
+  Device_SetRaw(device, index, pressed);
+  if (pressed) {
+    device->pending |= BIT_ULL(index);
+    if (input->type != EV_REL) {
+      return;
+    }
+    // motion never sends a release, so it counts as released at once
+    Device_SetRaw(device, index, false);
+  }
+  if (!device->pending || (device->raw & device->pending)) {
+    // still collecting the inputs for this button
+    return;
+  }
+  inputs = device->pending;
+  device->pending = 0;
+  is_terminal = (hweight64(inputs) == 1 && InputState_Compare(
+      &device->last_input, device->input_nodes + __ffs64(inputs)) == 0);
+  if (device->count == 0 && is_terminal) {
+    // first input can't be terminal
+    return;
+  }
+  if (!BindingTable_Add(device->banks[device->editing_bank], inputs,
+      SnesReportFormat_ButtonMask(g_report_format, device->count))) {
+    printk(KERN_DEBUG pr_fmt("Binding table full.\n"));
+    return;
+  }
+  device->bound |= SnesReportFormat_ButtonMask(g_report_format,
+      device->count);
+  printk(KERN_DEBUG pr_fmt("Adding button: %u, Inputs %#llx\n"),
+      device->count, inputs);
+  ++device->count;
+  if (is_terminal || device->count == g_report_format->num_buttons) {
+    Device_FinishBank(device);
+  }
+}
+
+// Feeds one digital input to the device, whatever its configuration state.
+static void Device_Input(struct Device *device,
+    const struct InputState *input, bool pressed) {
+  if (likely(device->config_state == kReady)) {
+    struct InputState *node;
+    if (unlikely(device->editing_bank != UGC_NO_BANK)) {
+      Device_Configure(device, input, pressed);
+      return;
+    }
+    node = InputState_Search(&device->input_code_to_index,
+        (struct InputState *)input);
+    if (node) {
+      device->input_state[node->value] = input->value;
+      Device_SetRaw(device, node->value, pressed);
+      if (input->type == EV_REL && pressed) {
+        device->motion |= BIT_ULL(node->value);
+      }
+    }
+  } else if (device->config_state == kConfiguring) {
+    Device_Configure(device, input, pressed);
+  } else if (pressed) {
+    if (InputState_Compare(&device->last_input, input) == 0) {
+      if (++device->count == UGC_CONFIGURE_REPEAT_COUNT) {
+        device->count = 0;
+        if (Device_ReserveBank(device, 0, GFP_ATOMIC) == 0) {
+          device->config_state = kConfiguring;
+        }
+      }
+    } else {
+      device->last_input = *input;
+      device->count = 1;
+    }
+  }
+}
+
+static void Device_AxisInput(struct Device *device, unsigned int code,
+    bool positive, bool pressed) {
+  const struct InputState input = {
+    .type = EV_ABS,
+    .code = code,
+    .positive = positive,
+    .value = pressed ? U32_MAX : 0,
+  };
+  Device_Input(device, &input, pressed);
+}
+
+// Only threshold crossings become inputs; samples between them cost two
+// compares and leave raw, and so the next commit, alone.
+static void Device_AbsEvent(struct Device *device, unsigned int code,
+    int value) {
+  struct Axis *axis;
+  unsigned int changed;
+  if (code >= ABS_MT_SLOT || device->axis_index[code] < 0) {
+    return;
+  }
+  axis = device->axes + device->axis_index[code];
+  changed = Axis_Update(axis, value);
+  if (changed & UGC_AXIS_NEGATIVE) {
+    Device_AxisInput(device, code, false,
+        axis->pressed & UGC_AXIS_NEGATIVE);
+  }
+  if (changed & UGC_AXIS_POSITIVE) {
+    Device_AxisInput(device, code, true,
+        axis->pressed & UGC_AXIS_POSITIVE);
+  }
+  if (code == ABS_X || code == ABS_Y) {
+    Device_UpdateStick(device);
+  }
+}
+
 static void EventHandler(struct input_handle *handle, unsigned int type, unsigned int code, int value)
 {
   struct Device *device;
@@ -297,78 +1427,74 @@ static void EventHandler(struct input_handle *handle, unsigned int type, unsigne
   //printk(KERN_DEBUG pr_fmt("Event. Dev: %s, Type: %s[%d], Code: %s[%d], Value: %d\n"),
   //    dev_name(&handle->dev->dev), event_name, type, code_name, code, value);
 
-  device = g_devices + UGC_NAME_TO_INDEX(handle->name);
-
+  device = handle->private;
 
-  if (type == EV_REL || type == EV_KEY) {
+  if (unlikely(atomic_read(&g_is_idle))) {
+    // read back from the input core's state on resume
+    device->stale = true;
+    return;
+  }
+  if (type == EV_SYN) {
+    // SYN_DROPPED never reaches handlers; evdev only queues it for its own
+    // clients
+    if (code != SYN_REPORT || device->config_state != kReady) {
+      if (code == SYN_REPORT) {
+        device->stale = false;
+      }
+      return;
+    }
+    if (unlikely(device->stale)) {
+      // a binding in progress only sees new events
+      device->stale = false;
+      if (device->editing_bank == UGC_NO_BANK) {
+        Device_Resync(device);
+        printk(KERN_DEBUG pr_fmt("Resynced device %d.\n"), device->index);
+      }
+    }
+    // frames that changed nothing don't republish
+    if (device->raw != device->published_raw ||
+        device->stick_direction != device->published_stick_direction) {
+      Device_Commit(device);
+    }
+    if (device->motion) {
+      // motion never sends a release; the taps keep the press for a latch
+      device->raw &= ~device->motion;
+      device->motion = 0;
+      Device_Commit(device);
+    }
+  } else if (unlikely(device->stale)) {
+    // the input core's state is read back at the next report
+    return;
+  } else if (type == EV_REL || type == EV_KEY) {
     struct InputState this_input = {
       .type = type,
       .code = code,
       .positive = true  // for EV_KEY
     };
+    bool pressed;
     if (type == EV_REL) {
-        struct input_absinfo* absinfo = device->dev->absinfo + code;
+        // relative devices have no absinfo; any motion is a full press
         if (value < 0) {
           this_input.positive = false;
-          // TODO: check absinfo->value vs value; prefer abs if match
-          this_input.value = NormalizeValue(value, 0, absinfo->minimum);
+          this_input.value = NormalizeValue(value, 0, -1);
         } else {
-          this_input.value = NormalizeValue(value, 0, absinfo->maximum);
+          this_input.value = NormalizeValue(value, 0, 1);
         }
     } else {
       this_input.value = NormalizeValue(value, 0, 1);
     }
+    pressed = (this_input.value > kPressedThreshold);
 
-    if (unlikely(device->config_state != kReady &&
-        this_input.value >= kPressedThreshold)) {
-      if (device->config_state == kConnected) {
-        if (InputState_Compare(&device->last_input, &this_input) == 0) {
-          if (++device->count == 10) {
-            device->config_state = kConfiguring;
-            device->count = 0;
-          }
-        } else {
-          device->last_input = this_input;
-          device->count = 1;
-        }
-      } else if (device->config_state == kConfiguring) {
-        const bool is_terminal = (
-            InputState_Compare(&device->last_input, &this_input) == 0);
-        struct InputState *node = InputState_Search(
-            &device->input_code_to_index, &this_input);
-        if (node || (device->count == 0 && is_terminal)) {
-          // no double bindings, and first input can't be terminal
-          return;
-        }
-        node = device->input_nodes + device->count;
-        *node = this_input;
-        node->value = device->count;
-        // TODO output more
-        printk(KERN_DEBUG pr_fmt("Adding button: %u, Code %u\n"),
-            node->value, node->code);
-        if (!InputState_Insert(&device->input_code_to_index, node)) {
-          printk(KERN_DEBUG pr_fmt("FAIL\n"));
-        }
-        ++device->count;
-        if (is_terminal) {
-          struct Device *old_device;
-          device->config_state = kReady;
-          old_device = g_active_device;
-          g_active_device = device;
-          if (old_device) {
-            Device_ResetConfig(old_device, NULL);
-          }
-        }
-      }
-    } else if (likely(device->config_state == kReady)) {
-      struct InputState *node;
-      node = InputState_Search(&device->input_code_to_index, &this_input);
-      if (node) {
-        device->input_state[node->value] = this_input.value;
-        printk(KERN_DEBUG pr_fmt("Button: %u, Value: %u\n"),
-            node->value, this_input.value);
+    if (type == EV_KEY && code == bank_hotkey && bank_hotkey) {
+      // never bound
+      if (device->config_state == kReady && value == 1) {
+        Device_BankHotkey(device);
       }
+    } else {
+      Device_Input(device, &this_input, pressed);
     }
+  } else if (type == EV_ABS) {
+    Device_AbsEvent(device, code, value);
   }
 }
 static const struct input_device_id g_id_match_table[] = {
@@ -387,12 +1513,19 @@ static struct input_handler g_InputHandler = {
 };
 
 static bool g_is_snes_gpio = false;
+static bool g_is_poll_engine = false;
 
 static int setup_snes_gpio(void) {
   int result;
   if (g_is_snes_gpio) {
     return 0;
   }
+  if (g_is_poll_engine) {
+    // the thread watches the clock; the latch only wakes it
+    g_snes_clock.input_irq_flags = 0;
+    g_snes_latch.input_irq_handler = SnesLatchWakeInterrupt;
+    g_snes_latch.input_irq_flags |= IRQF_NO_AUTOEN;
+  }
   result = PinConfig_Setup(&g_snes_data);
   if (result != 0) {
     return result;
@@ -422,20 +1555,363 @@ static void release_snes_gpio(void) {
   }
 }
 
+static bool g_is_idle_check = false;
+// Call once the console pins are set up.
+static int setup_idle(void) {
+  int result;
+  if (power_pin >= 0) {
+    g_snes_power.pin_number = power_pin;
+    result = PinConfig_Setup(&g_snes_power);
+    if (result != 0) {
+      return result;
+    }
+    g_is_power_pin = true;
+    if (!gpio_get_value(g_snes_power.pin_number)) {
+      EnterIdle();
+    }
+  }
+  if (idle_timeout_ms) {
+    g_is_idle_check = true;
+    schedule_delayed_work(&g_idle_check, msecs_to_jiffies(idle_timeout_ms));
+  }
+  return 0;
+}
+// Call before releasing the console pins.
+static void release_idle(void) {
+  if (g_is_power_pin) {
+    PinConfig_Release(&g_snes_power);
+    g_is_power_pin = false;
+  }
+  if (g_is_idle_check) {
+    cancel_delayed_work_sync(&g_idle_check);
+    g_is_idle_check = false;
+  }
+}
+
+// Call once idle is set up, so the thread sees its state.
+static int setup_poll_engine(void) {
+  const int cpu = poll_cpu;
+  if (cpu < 0) {
+    printk(KERN_DEBUG pr_fmt("The poll engine needs a poll_cpu\n"));
+    return -EINVAL;
+  }
+  if (cpu >= nr_cpu_ids || !cpu_online(cpu)) {
+    printk(KERN_DEBUG pr_fmt("Poll CPU %d is not online\n"), cpu);
+    return -EINVAL;
+  }
+  // a FIFO spinner would starve the housekeeping scheduled there
+  if (housekeeping_test_cpu(cpu, HK_TYPE_DOMAIN)) {
+    printk(KERN_DEBUG pr_fmt("Poll CPU %d is not isolated; boot with "
+        "isolcpus=%d\n"), cpu, cpu);
+    return -EINVAL;
+  }
+  g_poll_thread = kthread_create(SnesPollThread, NULL, "ugc_poll");
+  if (IS_ERR(g_poll_thread)) {
+    int result = PTR_ERR(g_poll_thread);
+    g_poll_thread = NULL;
+    return result;
+  }
+  kthread_bind(g_poll_thread, cpu);
+  sched_set_fifo(g_poll_thread);
+  wake_up_process(g_poll_thread);
+  printk(KERN_DEBUG pr_fmt("Polling the console on CPU %d\n"), cpu);
+  return 0;
+}
+// Call before releasing idle and the console pins.
+static void release_poll_engine(void) {
+  if (g_poll_thread) {
+    kthread_stop(g_poll_thread);
+    g_poll_thread = NULL;
+  }
+}
+
+static bool g_is_pad_reader = false;
+
+// publish is false when the pad is only merged into the console report
+static int setup_pad_reader(bool publish) {
+  int result;
+  if (g_is_pad_reader) {
+    return 0;
+  }
+  g_pad_reader.format = SnesReportFormat_Find(pad_format);
+  if (!g_pad_reader.format) {
+    printk(KERN_DEBUG pr_fmt("Unknown pad format: %s\n"), pad_format);
+    return -EINVAL;
+  }
+  if (pad_poll_rate == 0 || pad_poll_rate > 2000) {
+    printk(KERN_DEBUG pr_fmt("Pad poll rate out of range: %u\n"),
+        pad_poll_rate);
+    return -EINVAL;
+  }
+  if (publish) {
+    g_pad_reader.period = ns_to_ktime(NSEC_PER_SEC / pad_poll_rate);
+    result = PadReader_Setup(&g_pad_reader, "UGC Pad Reader");
+  } else {
+    g_pad_reader.period = 0;
+    result = PadReader_Setup(&g_pad_reader, NULL);
+  }
+  if (result != 0) {
+    return result;
+  }
+  g_is_pad_reader = true;
+  return 0;
+}
+static void release_pad_reader(void) {
+  if (g_is_pad_reader) {
+    PadReader_Release(&g_pad_reader);
+    g_is_pad_reader = false;
+  }
+}
+
+// Loading is asynchronous so init never waits on userspace or the disk.
+static void request_profile_firmware(void) {
+  int result;
+  if (!*profile_firmware) {
+    return;
+  }
+  g_root_device = root_device_register(HANDLER_NAME);
+  if (IS_ERR(g_root_device)) {
+    g_root_device = NULL;
+    return;
+  }
+  result = request_firmware_nowait(THIS_MODULE, FW_ACTION_UEVENT,
+      profile_firmware, g_root_device, GFP_KERNEL, NULL,
+      ProfileFirmwareLoaded);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("Profile firmware request failed with code: "
+        "%d\n"), result);
+  }
+}
+
 static bool g_is_handler_registered = false;
 static int __init Init(void) {
-  if (setup_snes_gpio()) {
-    g_is_handler_registered = true;
-    return input_register_handler(&g_InputHandler);
+  enum MergePolicy merge_policy;
+  enum InjectPolicy inject_policy;
+  int result;
+  if (strcmp(engine, "irq") == 0) {
+    g_is_poll_engine = false;
+  } else if (strcmp(engine, "poll") == 0) {
+    g_is_poll_engine = true;
+  } else {
+    printk(KERN_DEBUG pr_fmt("Unknown engine: %s\n"), engine);
+    return -EINVAL;
+  }
+  if (g_is_poll_engine && clock_irq[0]) {
+    // the thread watches the clock; no interrupt is requested for it
+    printk(KERN_DEBUG pr_fmt("clock_irq has no effect with engine=poll\n"));
+    return -EINVAL;
+  }
+  result = PinIrqPolicy_Parse(&g_snes_clock.input_irq_policy, clock_irq);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("Bad clock_irq: %s\n"), clock_irq);
+    return result;
+  }
+  result = PinIrqPolicy_Parse(&g_snes_latch.input_irq_policy, latch_irq);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("Bad latch_irq: %s\n"), latch_irq);
+    return result;
+  }
+  if (strcmp(merge, "none") == 0) {
+    merge_policy = kMergeReplace;
+  } else if (strcmp(merge, "or") == 0) {
+    merge_policy = kMergeOr;
+  } else if (strcmp(merge, "priority") == 0) {
+    merge_policy = kMergePriority;
+  } else {
+    printk(KERN_DEBUG pr_fmt("Unknown merge policy: %s\n"), merge);
+    return -EINVAL;
+  }
+  if (strcmp(inject, "off") == 0) {
+    inject_policy = kInjectOff;
+  } else if (strcmp(inject, "or") == 0) {
+    inject_policy = kInjectOr;
+  } else if (strcmp(inject, "override") == 0) {
+    inject_policy = kInjectOverride;
+  } else {
+    printk(KERN_DEBUG pr_fmt("Unknown inject policy: %s\n"), inject);
+    return -EINVAL;
+  }
+  if (axis_press_percent == 0 || axis_press_percent > 100 ||
+      axis_release_percent > axis_press_percent) {
+    printk(KERN_DEBUG pr_fmt("Axis thresholds out of range: %u/%u\n"),
+        axis_press_percent, axis_release_percent);
+    return -EINVAL;
+  }
+  if (tas_frames > UGC_TAS_MAX_FRAMES) {
+    printk(KERN_DEBUG pr_fmt("tas_frames above %u: %u\n"),
+        UGC_TAS_MAX_FRAMES, tas_frames);
+    return -EINVAL;
+  }
+  g_report_format = SnesReportFormat_Find(report_format);
+  if (!g_report_format) {
+    printk(KERN_DEBUG pr_fmt("Unknown report format: %s\n"), report_format);
+    return -EINVAL;
+  }
+  if (num_tap_frames > 1 && num_tap_frames != g_report_format->num_buttons) {
+    printk(KERN_DEBUG pr_fmt("tap_frames needs 1 or %u values, not %u\n"),
+        g_report_format->num_buttons, num_tap_frames);
+    return -EINVAL;
+  }
+  DpadBits_Init(&g_dpad_bits, g_report_format);
+  TapCapture_Init(&g_tap_capture, g_report_format, tap_frames,
+      num_tap_frames);
+  if (num_turbo_frames && num_turbo_frames != g_report_format->num_buttons) {
+    printk(KERN_DEBUG pr_fmt("turbo_frames needs %u values, not %u\n"),
+        g_report_format->num_buttons, num_turbo_frames);
+    return -EINVAL;
+  }
+  Turbo_Init(&g_turbo, g_report_format, turbo_frames, num_turbo_frames);
+  if (strcmp(socd, "none") == 0) {
+    Socd_Init(&g_socd, kSocdNone, &g_dpad_bits);
+  } else if (strcmp(socd, "neutral") == 0) {
+    Socd_Init(&g_socd, kSocdNeutral, &g_dpad_bits);
+  } else if (strcmp(socd, "up") == 0) {
+    Socd_Init(&g_socd, kSocdUpPriority, &g_dpad_bits);
+  } else if (strcmp(socd, "last") == 0) {
+    Socd_Init(&g_socd, kSocdLastWins, &g_dpad_bits);
+  } else {
+    printk(KERN_DEBUG pr_fmt("Unknown SOCD policy: %s\n"), socd);
+    return -EINVAL;
+  }
+  if (stick_dpad) {
+    if (StickDpad_Init(&g_stick_dpad, stick_dpad, stick_dpad_diagonal,
+        stick_dpad_deadzone) != 0) {
+      printk(KERN_DEBUG pr_fmt("Bad stick d-pad: %u ways, %u degrees, "
+          "%u%%\n"), stick_dpad, stick_dpad_diagonal, stick_dpad_deadzone);
+      return -EINVAL;
+    }
+    g_is_stick_dpad = true;
+  }
+  result = Controller_Init(&g_controller, merge_policy);
+  if (result != 0) {
+    return result;
+  }
+  ProfileCache_Init(&g_profile_cache);
+  g_device_cache = kmem_cache_create("ugc_device", sizeof(struct Device),
+      0, 0, NULL);
+  if (!g_device_cache) {
+    result = -ENOMEM;
+    goto err_release_controller;
+  }
+  // before any interrupt or commit can publish to it
+  result = StatePage_Setup(&g_state_page, g_report_format);
+  if (result != 0) {
+    goto err_destroy_cache;
+  }
+  result = Inject_Setup(&g_inject, inject_policy);
+  if (result != 0) {
+    goto err_release_state_page;
+  }
+  result = Tas_Setup(&g_tas, tas_frames);
+  if (result != 0) {
+    goto err_release_inject;
+  }
+  if (strcmp(mode, "console") == 0) {
+    g_mode = kModeConsole;
+    result = setup_snes_gpio();
+  } else if (strcmp(mode, "reader") == 0) {
+    g_mode = kModeReader;
+    result = setup_pad_reader(true);
+  } else if (strcmp(mode, "interposer") == 0) {
+    g_mode = kModeInterposer;
+    // the reader must exist before the latch interrupt can fire
+    result = setup_pad_reader(false);
+    if (result == 0) {
+      Interposer_Init(&g_interposer, &g_pad_reader,
+          us_to_ktime(interposer_lead_us));
+      result = setup_snes_gpio();
+      if (result != 0) {
+        release_pad_reader();
+      }
+    }
+  } else if (strcmp(mode, "gamepad") == 0) {
+    g_mode = kModeGamepad;
+    result = GamepadOutput_Setup(&g_gamepad_output, g_report_format);
+  } else {
+    printk(KERN_DEBUG pr_fmt("Unknown mode: %s\n"), mode);
+    result = -EINVAL;
+  }
+  if (result != 0) {
+    goto err_release_tas;
+  }
+  if (g_mode == kModeConsole || g_mode == kModeInterposer) {
+    result = setup_idle();
+    if (result == 0 && g_is_poll_engine) {
+      result = setup_poll_engine();
+    }
+  } else if (power_pin >= 0 || idle_timeout_ms ||
+      inject_policy != kInjectOff || tas_frames || g_is_poll_engine) {
+    printk(KERN_DEBUG pr_fmt("Idle, inject, TAS and polling need a console "
+        "latch; mode is %s\n"), mode);
+    result = -EINVAL;
+  }
+  if (result != 0) {
+    goto err_release_gpio;
+  }
+  result = input_register_handler(&g_InputHandler);
+  if (result != 0) {
+    goto err_release_gpio;
+  }
+  g_is_handler_registered = true;
+  result = MappingBpf_Setup();
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("No BPF mapping kfuncs: %d\n"), result);
+  }
+  Stats_Setup();
+  ProfileCache_CreateDebugfs(&g_profile_cache, Stats_Directory());
+  g_profile_configfs.format = g_report_format;
+  result = ProfileConfigfs_Setup(&g_profile_configfs);
+  if (result != 0) {
+    printk(KERN_DEBUG pr_fmt("No configfs mapping upload: %d\n"), result);
   }
-  return -1;
+  request_profile_firmware();
+  return 0;
+
+err_release_gpio:
+  GamepadOutput_Release(&g_gamepad_output);
+  release_poll_engine();
+  release_idle();
+  release_snes_gpio();
+  cancel_work_sync(&g_resync_work);
+  release_pad_reader();
+err_release_tas:
+  Tas_Release(&g_tas);
+err_release_inject:
+  Inject_Release(&g_inject);
+err_release_state_page:
+  StatePage_Release(&g_state_page);
+err_destroy_cache:
+  kmem_cache_destroy(g_device_cache);
+err_release_controller:
+  Controller_Release(&g_controller);
+  return result;
 }
 
 static void __exit Exit(void) {
+  ProfileConfigfs_Release(&g_profile_configfs);
+  Stats_Release();
+  release_poll_engine();
+  release_idle();
   release_snes_gpio();
+  // queued by a latch until its interrupt was freed
+  cancel_work_sync(&g_resync_work);
+  release_pad_reader();
   if (g_is_handler_registered) {
     input_unregister_handler(&g_InputHandler);
   }
+  GamepadOutput_Release(&g_gamepad_output);
+  Tas_Release(&g_tas);
+  Inject_Release(&g_inject);
+  StatePage_Release(&g_state_page);
+  // every device was deleted as its handle disconnected
+  kmem_cache_destroy(g_device_cache);
+  ida_destroy(&g_device_ida);
+  Controller_Release(&g_controller);
+  // a pending firmware request holds a module reference, so it is done
+  if (g_root_device) {
+    root_device_unregister(g_root_device);
+  }
+  ProfileCache_Clear(&g_profile_cache);
 }
 
 module_init(Init);